@@ -0,0 +1,71 @@
+/** allocbench - Compare the so/rc pool allocator against malloc/free
+ *
+ * Churns a fixed set of live 32-byte blocks, freeing and reallocating one
+ * block per step, first with malloc/free and then with poolAlloc32/poolFree32
+ * (the entry points generated code calls for a 32-byte so/rc allocation).
+ * Usage: allocbench [steps]
+ *
+ * This source file is part of the Cone Programming Language C compiler
+ * See Copyright Notice in conec.h
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+char *poolAlloc32();
+void poolFree32(char *p);
+
+#define BenchLive 1024
+
+static char *live[BenchLive];
+
+static double benchNow() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static double benchMalloc(long steps) {
+    double start = benchNow();
+    for (long i = 0; i < steps; ++i) {
+        int k = i & (BenchLive - 1);
+        if (live[k])
+            free(live[k]);
+        live[k] = malloc(32);
+        live[k][0] = 1;
+    }
+    for (int k = 0; k < BenchLive; ++k) {
+        free(live[k]);
+        live[k] = NULL;
+    }
+    return benchNow() - start;
+}
+
+static double benchPool(long steps) {
+    double start = benchNow();
+    for (long i = 0; i < steps; ++i) {
+        int k = i & (BenchLive - 1);
+        if (live[k])
+            poolFree32(live[k]);
+        live[k] = poolAlloc32();
+        live[k][0] = 1;
+    }
+    for (int k = 0; k < BenchLive; ++k) {
+        poolFree32(live[k]);
+        live[k] = NULL;
+    }
+    return benchNow() - start;
+}
+
+int main(int argc, char **argv) {
+    long steps = argc > 1 ? atol(argv[1]) : 100000000L;
+    if (steps <= 0)
+        return 1;
+    // The first round warms up both allocators
+    for (int round = 0; round < 2; ++round) {
+        printf("malloc/free:           %.2f ns/op\n", benchMalloc(steps) * 1e9 / steps);
+        printf("poolAlloc32/poolFree32: %.2f ns/op\n", benchPool(steps) * 1e9 / steps);
+    }
+    return 0;
+}
@@ -2,11 +2,11 @@
 
 # Generate the C files
 set(CMAKE_CONE_COMPILE_OBJECT
-        "<CMAKE_CONE_COMPILER> -o CMakeFiles/<TARGET>.dir/<TARGET> <SOURCE>")
+        "<CMAKE_CONE_COMPILER> <FLAGS> -o <OBJECT_FILE_DIR> <SOURCE>")
 
 # Build a executable
 set(CMAKE_CONE_LINK_EXECUTABLE
-        "<CMAKE_C_COMPILER> -o <TARGET> <OBJECTS>")
+        "<CMAKE_C_COMPILER> -o <TARGET> <OBJECTS> <LINK_LIBRARIES>")
 
 set(CMAKE_CONE_INFORMATION_LOADED 1)
 
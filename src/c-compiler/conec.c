@@ -20,7 +20,7 @@
 #include <assert.h>
 
 // Run all semantic analysis passes against the AST/IR (after parse and before gen)
-void doAnalysis(ProgramNode **pgm) {
+void doAnalysis(ProgramNode **pgm, ConeOptions *opt) {
 
     // Resolve all name uses to their appropriate declaration
     // Note: Some nodes may be replaced (e.g., 'a' to 'self.a')
@@ -31,7 +31,7 @@ void doAnalysis(ProgramNode **pgm) {
     nstate.scope = 0;
     nstate.flags = 0;
     inodeNameRes(&nstate, (INode**)pgm);
-    if (errors)
+    if (errors || opt->stop_after == StopAfterNameRes)
         return;
 
     // Apply syntactic sugar, and perform type inference/check:
@@ -52,6 +52,10 @@ void doAnalysis(ProgramNode **pgm) {
     TypeCheckState tstate;
     tstate.fn = NULL;
     tstate.typenode = NULL;
+    tstate.scope = 0;
+    tstate.flags = opt->stop_after == StopAfterTypeCheck ? TypeCheckNoFlow : 0;
+    if (opt->no_rc_elide)
+        tstate.flags |= TypeCheckNoRcElide;
     inodeTypeCheckAny(&tstate, (INode**)pgm);
 }
 
@@ -64,27 +68,35 @@ int main(int argc, char **argv) {
     ok = coneOptSet(&coneopt, &argc, argv);
     if (ok <= 0)
         exit(ok == 0 ? 0 : ExitOpts);
+    errorSetup(coneopt.diag_json, coneopt.max_errors);
     if (argc < 2)
         errorExit(ExitOpts, "Specify a Cone program to compile.");
     coneopt.srcpath = argv[1];
     coneopt.srcname = fileName(coneopt.srcpath);
 
-    // We set up generation early because we need target info, e.g.: pointer size
+    // Parsing and analysis only need to know the target's pointer size.
+    // Full generation setup is deferred until we know we will generate code.
     timerBegin(SetupTimer);
-    genSetup(&gen, &coneopt);
+    genTargetInfo(&coneopt);
 
     // Parse source file, do semantic analysis, and generate code
     timerBegin(ParseTimer);
     ProgramNode* pgmnode = parsePgm(&coneopt);
-    if (errors == 0) {
+    if (errors == 0 && coneopt.stop_after != StopAfterParse) {
         timerBegin(SemTimer);
-        doAnalysis(&pgmnode);
-        if (errors == 0) {
-            timerBegin(GenTimer);
+        doAnalysis(&pgmnode, &coneopt);
+        if (errors == 0 && coneopt.stop_after != StopAfterNameRes) {
             if (coneopt.print_ir)
-                inodePrint(coneopt.output, coneopt.srcpath, (INode*)pgmnode);
-            genpgm(&gen, pgmnode);
-            genClose(&gen);
+                inodePrint(coneopt.output, coneopt.srcname, (INode*)pgmnode);
+            if (coneopt.print_ir_json)
+                inodePrintJson(coneopt.output, coneopt.srcname, (INode*)pgmnode);
+            if (coneopt.stop_after == StopAfterNone || coneopt.stop_after > StopAfterFlow) {
+                timerBegin(SetupTimer);
+                genSetup(&gen, &coneopt);
+                timerBegin(GenTimer);
+                genpgm(&gen, pgmnode);
+                genClose(&gen);
+            }
         }
     }
     timerBegin(TimerCount);
@@ -39,20 +39,30 @@ enum
     OPT_STATS,
     OPT_LINK_ARCH,
     OPT_LINKER,
+    OPT_PRELEX,
+    OPT_RC32,
+    OPT_UNCHECKED,
+    OPT_NOSTRICTALIAS,
+    OPT_STOPAFTER,
 
     OPT_VERBOSE,
     OPT_IR,
+    OPT_IRJSON,
     OPT_ASM,
     OPT_LLVMIR,
     OPT_TRACE,
     OPT_WIDTH,
     OPT_IMMERR,
+    OPT_DIAGJSON,
+    OPT_MAXERRORS,
     OPT_VERIFY,
     OPT_FILENAMES,
     OPT_CHECKTREE,
     OPT_EXTFUN,
     OPT_SIMPLEBUILTIN,
     OPT_LINT_LLVM,
+    OPT_RCCOUNT,
+    OPT_NORCELIDE,
 
     OPT_BNF,
     OPT_ANTLR,
@@ -83,20 +93,30 @@ static opt_arg_t args[] =
     { "stats", '\0', OPT_ARG_NONE, OPT_STATS },
     { "link-arch", '\0', OPT_ARG_REQUIRED, OPT_LINK_ARCH },
     { "linker", '\0', OPT_ARG_REQUIRED, OPT_LINKER },
+    { "prelex", '\0', OPT_ARG_NONE, OPT_PRELEX },
+    { "rc32", '\0', OPT_ARG_NONE, OPT_RC32 },
+    { "unchecked-bounds", '\0', OPT_ARG_NONE, OPT_UNCHECKED },
+    { "no-strict-aliasing", '\0', OPT_ARG_NONE, OPT_NOSTRICTALIAS },
+    { "stop-after", '\0', OPT_ARG_REQUIRED, OPT_STOPAFTER },
 
     { "verbose", 'V', OPT_ARG_REQUIRED, OPT_VERBOSE },
     { "ir", '\0', OPT_ARG_NONE, OPT_IR },
+    { "ir-json", '\0', OPT_ARG_NONE, OPT_IRJSON },
     { "asm", '\0', OPT_ARG_NONE, OPT_ASM },
     { "llvmir", '\0', OPT_ARG_NONE, OPT_LLVMIR },
     { "trace", 't', OPT_ARG_NONE, OPT_TRACE },
     { "width", 'w', OPT_ARG_REQUIRED, OPT_WIDTH },
     { "immerr", '\0', OPT_ARG_NONE, OPT_IMMERR },
+    { "diag-json", '\0', OPT_ARG_NONE, OPT_DIAGJSON },
+    { "max-errors", '\0', OPT_ARG_REQUIRED, OPT_MAXERRORS },
     { "verify", '\0', OPT_ARG_NONE, OPT_VERIFY },
     { "files", '\0', OPT_ARG_NONE, OPT_FILENAMES },
     { "checktree", '\0', OPT_ARG_NONE, OPT_CHECKTREE },
     { "extfun", '\0', OPT_ARG_NONE, OPT_EXTFUN },
     { "simplebuiltin", '\0', OPT_ARG_NONE, OPT_SIMPLEBUILTIN },
     { "lint-llvm", '\0', OPT_ARG_NONE, OPT_LINT_LLVM },
+    { "rc-count", '\0', OPT_ARG_NONE, OPT_RCCOUNT },
+    { "no-rc-elide", '\0', OPT_ARG_NONE, OPT_NORCELIDE },
 
     OPT_ARGS_FINISH
 };
@@ -142,6 +162,14 @@ static void usage()
         "    =name         Default is the host architecture.\n"
         "  --linker        Set the linker command to use.\n"
         "    =name         Default is the compiler.\n"
+        "  --prelex        Lex each source file fully before parsing it.\n"
+        "  --rc32          Use 32-bit reference counters for rc and arc.\n"
+        "  --unchecked-bounds\n"
+        "                  Trust array indexes: no runtime bounds checks.\n"
+        "  --no-strict-aliasing\n"
+        "                  Allow memory of one type to be read as another (no TBAA).\n"
+        "  --stop-after    Stop compiling after a phase.\n"
+        "    =phase        parse, nameres, typecheck, flow, llvm or opt.\n"
         ,
         "Debugging options:\n"
         "  --verbose, -V   Verbosity level.\n"
@@ -151,18 +179,24 @@ static void usage()
         "    =3            External tool command lines.\n"
         "    =4            Very low-level detail.\n"
         "  --ir            Output an IR tree for the whole program.\n"
+        "  --ir-json       Output the program's IR as JSON lines, one per declaration.\n"
         "  --asm           Output an assembly file.\n"
         "  --llvmir        Output an LLVM IR file.\n"
         "  --trace, -t     Enable parse trace.\n"
         "  --width, -w     Width to target when printing the IR.\n"
         "    =columns      Defaults to the terminal width.\n"
         "  --immerr        Report errors immediately rather than deferring.\n"
+        "  --diag-json     Report all diagnostics at exit as one JSON document.\n"
+        "  --max-errors    Stop compiling after this many errors.\n"
+        "    =count        Defaults to 0 (no limit).\n"
         "  --checktree     Verify IR well-formedness.\n"
         "  --verify        Verify LLVM IR.\n"
         "  --extfun        Set function default linkage to external.\n"
         "  --simplebuiltin Use a minimal builtin package.\n"
         "  --files         Print source file names as each is processed.\n"
         "  --lint-llvm     Run the LLVM linting pass on generated IR.\n"
+        "  --rc-count      Count executed rc/arc counter updates, printed at exit.\n"
+        "  --no-rc-elide   Keep every rc/arc counter update (no coalescing or elision).\n"
         ,
         "" // "Runtime options for Cone programs (not for use with Cone compiler):\n"
     );
@@ -268,19 +302,42 @@ int coneOptSet(ConeOptions *opt, int *argc, char **argv) {
         case OPT_STATS: opt->print_stats = 1; break;
         case OPT_LINK_ARCH: opt->link_arch = s.arg_val; break;
         case OPT_LINKER: opt->linker = s.arg_val; break;
+        case OPT_PRELEX: opt->prelex = 1; break;
+        case OPT_RC32: opt->rc32 = 1; break;
+        case OPT_UNCHECKED: opt->unchecked_bounds = 1; break;
+        case OPT_NOSTRICTALIAS: opt->no_strict_aliasing = 1; break;
+        case OPT_STOPAFTER:
+        {
+            static char *phases[] = {"", "parse", "nameres", "typecheck", "flow", "llvm", "opt"};
+            opt->stop_after = StopAfterNone;
+            for (i = StopAfterParse; i <= StopAfterOpt; i++) {
+                if (strcmp(s.arg_val, phases[i]) == 0)
+                    opt->stop_after = i;
+            }
+            if (opt->stop_after == StopAfterNone) {
+                printf("Unrecognised compiler phase: %s\n", s.arg_val);
+                ok = 0;
+            }
+        }
+        break;
 
         case OPT_IR: opt->print_ir = 1; break;
+        case OPT_IRJSON: opt->print_ir_json = 1; break;
         case OPT_ASM: opt->print_asm = 1; break;
         case OPT_LLVMIR: opt->print_llvmir = 1; break;
         case OPT_TRACE: opt->parse_trace = 1; break;
         case OPT_WIDTH: opt->ir_print_width = atoi(s.arg_val); break;
             // case OPT_IMMERR: errors_set_immediate(opt.check.errors, 1); break;
+        case OPT_DIAGJSON: opt->diag_json = 1; break;
+        case OPT_MAXERRORS: opt->max_errors = atoi(s.arg_val); break;
         case OPT_VERIFY: opt->verify = 1; break;
         case OPT_EXTFUN: opt->extfun = 1; break;
         case OPT_SIMPLEBUILTIN: opt->simple_builtin = 1; break;
         case OPT_FILENAMES: opt->print_filenames = 1; break;
         case OPT_CHECKTREE: opt->check_tree = 1; break;
         case OPT_LINT_LLVM: opt->lint_llvm = 1; break;
+        case OPT_RCCOUNT: opt->rc_count = 1; break;
+        case OPT_NORCELIDE: opt->no_rc_elide = 1; break;
 
         case OPT_VERBOSE:
         {
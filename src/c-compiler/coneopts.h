@@ -34,6 +34,7 @@ typedef struct ConeOptions {
     void* data; // User-defined data for unit test callbacks
 
     int ptrsize;    // Size of a pointer (in bits)
+    int stop_after;  // Last compiler phase to run (see StopAfter)
 
     // Boolean flags
     int wasm;        // 1=WebAssembly
@@ -48,13 +49,22 @@ typedef struct ConeOptions {
     int strip_debug;    // Strip debug info
     int print_filenames;    // Print source file names as each is processed
     int print_ir;        // Print out IR
+    int print_ir_json;   // Print out IR as JSON lines
     int print_asm;        // Print out assembly file
     int print_llvmir;    // Print out LLVM IR
     int check_tree;        // Verify IR well-formedness
     int lint_llvm;        // Run the LLVM linting pass on generated IR
+    int rc_count;         // Count executed rc/arc counter updates (see conestd/rccount.c)
+    int no_rc_elide;      // Keep every rc/arc counter update the flow pass could remove
+    int prelex;          // Lex each source file into a token buffer before parsing it
+    int rc32;            // Use 32-bit counters for rc/arc references
+    int unchecked_bounds;  // Omit runtime array bounds checks
+    int no_strict_aliasing;  // Omit type-based alias analysis (TBAA) metadata
     int docs;            // Generate code documentation
     int docs_private;    // Generate code docs for private
     int verbosity;       // 0 - 4 (0 = default)
+    int diag_json;       // Report diagnostics as JSON at exit
+    int max_errors;      // Stop compiling after this many errors (0 = no limit)
 
     // verbosity_level verbosity;
 
@@ -63,6 +73,17 @@ typedef struct ConeOptions {
     int parse_trace;
 } ConeOptions;
 
+// Compiler phases that --stop-after may end the compile after
+enum StopAfter {
+    StopAfterNone,       // Run every phase
+    StopAfterParse,
+    StopAfterNameRes,
+    StopAfterTypeCheck,  // Type check, without data flow analysis
+    StopAfterFlow,
+    StopAfterLlvm,       // Generate LLVM IR, without optimizing it
+    StopAfterOpt         // Optimize LLVM IR, without generating object code
+};
+
 int coneOptSet(ConeOptions *opt, int *argc, char **argv);
 
 #endif
@@ -72,14 +72,53 @@ char *corelibSource =
 "struct @move so:\n"
 "  fn _alloc(size usize) *u8 inline {malloc(size)}\n"
 
+// rc and arc's counter type ($cnt) is filled in by stdlibInit
 "struct rc:\n"
-"  cnt usize\n"
+"  cnt $cnt\n"
 "  fn _alloc(size usize) *u8 inline {malloc(size)}\n"
-"  fn init() rc inline {rc[1usize]}\n"
+"  fn init() rc inline {rc[1$cnt]}\n"
+
+// arc is rc whose counter is updated atomically, so its references may be shared across threads
+"struct arc:\n"
+"  cnt $cnt\n"
+"  fn _alloc(size usize) *u8 inline {malloc(size)}\n"
+"  fn init() arc inline {arc[1$cnt]}\n"
+
+// Arena references are bump allocated inline (see genlArenaAlloc) from the thread's
+// current chunk. arenaAlloc gets a new chunk when it runs out of room.
+// They are never freed one at a time. The host releases the thread's chunks with
+// the runtime's arenaRelease() or arenaFree() (see conestd/arena.h). These are not
+// declared here: Cone code calling them would leave any live arena reference dangling.
+"extern fn arenaAlloc(size usize) *u8\n"
+"struct arena:\n"
+"  fn _alloc(size usize) *u8 inline {arenaAlloc(size)}\n"
 ;
 
+// Return a copy of source with every occurrence of marker replaced by text
+char *corelibReplace(char *source, char *marker, char *text) {
+    size_t markerlen = strlen(marker);
+    size_t textlen = strlen(text);
+    size_t count = 0;
+    char *found;
+    for (char *scan = source; (found = strstr(scan, marker)); scan = found + markerlen)
+        ++count;
+
+    char *result = memAllocBlk(strlen(source) + count * textlen + 1);
+    char *out = result;
+    while ((found = strstr(source, marker))) {
+        memcpy(out, source, found - source);
+        out += found - source;
+        memcpy(out, text, textlen);
+        out += textlen;
+        source = found + markerlen;
+    }
+    strcpy(out, source);
+    return result;
+}
+
 // Set up the standard library, whose names are always shared by all modules
-void stdlibInit(int ptrsize) {
+// rc/arc counters are usize, unless rc32 packs them into a u32 (for smaller rc allocations)
+void stdlibInit(int ptrsize, int rc32) {
 
     unknownType = (INode*)newAbsenceNode();
     unknownType->tag = UnknownTag;
@@ -92,4 +131,6 @@ void stdlibInit(int ptrsize) {
     staticLifetimeNode = newLifetimeDclNode(nametblFind("'static", 7), 0);
     stdPermInit();
     stdNbrInit(ptrsize);
+
+    corelibSource = corelibReplace(corelibSource, "$cnt", rc32 ? "u32" : "usize");
 }
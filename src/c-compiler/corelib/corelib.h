@@ -46,7 +46,7 @@ extern INsTypeNode *arrayRefType;
 
 extern char *corelibSource;
 
-void stdlibInit(int ptrsize);
+void stdlibInit(int ptrsize, int rc32);
 void keywordInit();
 void stdNbrInit(int ptrsize);
 
@@ -30,23 +30,40 @@ void genlRefTypeSetup(GenState *gen, RefNode *reftype) {
 
     RefTypeInfo *refinfo = reftype->typeinfo;
 
-    // Build composite struct, with "fields" for region, perm, and vtype
+    // Build composite struct, with "fields" for region, perm, and vtype.
+    // Zero-size regions (so) and permissions (all but locks) take no field.
+    // When both are present, the more aligned one goes first to avoid padding between them.
+    // The value is always last, as array refs allocate more elements past its end.
+    LLVMTypeRef regiontype = genlType(gen, reftype->region);
+    LLVMTypeRef permtype = genlType(gen, reftype->perm);
+    int hasregion = LLVMABISizeOfType(gen->datalayout, regiontype) > 0;
+    int hasperm = LLVMABISizeOfType(gen->datalayout, permtype) > 0;
+    int permfirst = hasregion && hasperm
+        && LLVMABIAlignmentOfType(gen->datalayout, permtype) > LLVMABIAlignmentOfType(gen->datalayout, regiontype);
     LLVMTypeRef field_types[3];
-    LLVMTypeRef *fieldtypep = &field_types[0];
-    *fieldtypep++ = genlType(gen, reftype->region);
-    *fieldtypep++ = genlType(gen, reftype->perm);
-    *fieldtypep = genlType(gen, reftype->vtexp);
+    int fieldcnt = 0;
+    if (permfirst) {
+        refinfo->permfield = fieldcnt;
+        field_types[fieldcnt++] = permtype;
+    }
+    if (hasregion) {
+        refinfo->regionfield = fieldcnt;
+        field_types[fieldcnt++] = regiontype;
+    }
+    if (hasperm && !permfirst) {
+        refinfo->permfield = fieldcnt;
+        field_types[fieldcnt++] = permtype;
+    }
+    refinfo->valuefield = fieldcnt;
+    field_types[fieldcnt++] = genlType(gen, reftype->vtexp);
     LLVMTypeRef structype = LLVMStructCreateNamed(gen->context, "refstruct");
-    LLVMStructSetBody(structype, field_types, 3, 0);
+    LLVMStructSetBody(structype, field_types, fieldcnt, 0);
     refinfo->structype = structype;
 
     refinfo->ptrstructype = LLVMPointerType(structype, 0);
 }
 
 
-// Function declarations for malloc() and free()
-LLVMValueRef genlfreeval = NULL;
-
 // If ref type is struct, dealias any fields holding rc/own references
 void genlDealiasFlds(GenState *gen, LLVMValueRef ref, RefNode *refnode) {
     StructNode *strnode = (StructNode*) iTypeGetTypeDcl(refnode->vtexp);
@@ -57,7 +74,7 @@ void genlDealiasFlds(GenState *gen, LLVMValueRef ref, RefNode *refnode) {
     for (nodelistFor(&strnode->fields, cnt, nodesp)) {
         FieldDclNode *field = (FieldDclNode *)*nodesp;
         RefNode *vartype = (RefNode *)field->vtype;
-        if (vartype->tag != RefTag || !(isRegion(vartype->region, rcName) || isRegion(vartype->region, soName)))
+        if (vartype->tag != RefTag || !(isRcRegion(vartype->region) || isRegion(vartype->region, soName)))
             continue;
         LLVMValueRef fldref = LLVMBuildStructGEP(gen->builder, ref, field->index, &field->namesym->namestr);
         if (isRegion(vartype->region, soName))
@@ -67,60 +84,176 @@ void genlDealiasFlds(GenState *gen, LLVMValueRef ref, RefNode *refnode) {
     }
 }
 
-// Call free() (and generate declaration if needed)
-LLVMValueRef genlFree(GenState *gen, LLVMValueRef ref) {
+// Return the pool size class for a fixed-size so/rc allocation, or -1 if it should use malloc().
+// arc allocations use malloc(): the last reference may be dropped on another thread, and
+// the pool's free lists are thread-local, so the block would move to that thread's pool.
+int genlPoolClass(GenState *gen, RefNode *reftype) {
+    if (reftype->tag != RefTag || !(isRegion(reftype->region, soName) || isRegion(reftype->region, rcName)))
+        return -1;
+    long long allocsize = LLVMABISizeOfType(gen->datalayout, reftype->typeinfo->structype);
+    if (allocsize > GenPoolMaxSize)
+        return -1;
+    return allocsize == 0 ? 0 : (int)((allocsize - 1) / GenPoolGranule);
+}
+
+// Point back from a reference's value to the start of its allocation
+LLVMValueRef genlRefAllocStart(GenState *gen, LLVMValueRef ref, RefNode *refnode) {
+    RefTypeInfo *refinfo = refnode->typeinfo;
+    LLVMTypeRef u8ptr = LLVMPointerType(LLVMInt8TypeInContext(gen->context), 0);
+    LLVMValueRef start = LLVMBuildBitCast(gen->builder, ref, u8ptr, "");
+    unsigned long long valueoffset = LLVMOffsetOfElement(gen->datalayout, refinfo->structype, refinfo->valuefield);
+    if (valueoffset > 0) {
+        LLVMValueRef back = LLVMConstInt(genlType(gen, (INode*)usizeType), -(long long)valueoffset, 1);
+        start = LLVMBuildGEP(gen->builder, start, &back, 1, "allocstart");
+    }
+    return start;
+}
+
+// Call a size-class pool entry point (and generate its declaration if needed)
+LLVMValueRef genlPoolCall(GenState *gen, LLVMValueRef *fns, char *prefix, int sizeclass, LLVMValueRef ref) {
+    LLVMTypeRef u8ptr = LLVMPointerType(LLVMInt8TypeInContext(gen->context), 0);
+    int isfree = ref != NULL;
+    if (fns[sizeclass] == NULL) {
+        char fnname[32];
+        sprintf(fnname, "%s%d", prefix, (sizeclass + 1) * GenPoolGranule);
+        LLVMTypeRef fnsig = isfree? LLVMFunctionType(LLVMVoidTypeInContext(gen->context), &u8ptr, 1, 0)
+            : LLVMFunctionType(u8ptr, NULL, 0, 0);
+        fns[sizeclass] = LLVMAddFunction(gen->module, fnname, fnsig);
+    }
+    if (!isfree)
+        return LLVMBuildCall(gen->builder, fns[sizeclass], NULL, 0, "");
+    LLVMValueRef refcast = LLVMBuildBitCast(gen->builder, ref, u8ptr, "");
+    return LLVMBuildCall(gen->builder, fns[sizeclass], &refcast, 1, "");
+}
+
+// Free a so/rc allocation, returning it to its size-class pool
+// or calling free() (and generating its declaration if needed)
+LLVMValueRef genlFree(GenState *gen, LLVMValueRef ref, RefNode *refnode) {
+    int sizeclass = genlPoolClass(gen, refnode);
+    if (sizeclass >= 0)
+        return genlPoolCall(gen, gen->poolfreefn, "poolFree", sizeclass, ref);
+
     LLVMTypeRef parmtype = LLVMPointerType(LLVMInt8TypeInContext(gen->context), 0);
     // Declare free() external function
-    if (genlfreeval == NULL) {
+    if (gen->freefn == NULL) {
         LLVMTypeRef rettype = LLVMVoidTypeInContext(gen->context);
         LLVMTypeRef fnsig = LLVMFunctionType(rettype, &parmtype, 1, 0);
-        genlfreeval = LLVMAddFunction(gen->module, "free", fnsig);
+        gen->freefn = LLVMAddFunction(gen->module, "free", fnsig);
     }
     // Cast ref to *u8 and then call free()
     LLVMValueRef refcast = LLVMBuildBitCast(gen->builder, ref, parmtype, "");
-    return LLVMBuildCall(gen->builder, genlfreeval, &refcast, 1, "");
+    return LLVMBuildCall(gen->builder, gen->freefn, &refcast, 1, "");
 }
 
-// Generate repetitive array fill of a value
+// Generate repetitive array fill of a value.
+// A byte-splat value (e.g., zero) is filled using llvm.memset. Otherwise, the first
+// element is stored, and then the filled part is doubled using llvm.memcpy until done.
 void genlAllocFillArray(GenState *gen, LLVMValueRef nbrelems, ArrayNode *arraylit, LLVMValueRef valuep) {
-    LLVMValueRef ptrphis[2];
-    LLVMValueRef cntphis[2];
+    LLVMValueRef fillval = genlExpr(gen, nodesGet(arraylit->elems, 0));
+    LLVMTypeRef usize = genlUsize(gen);
+    LLVMTypeRef bytep = LLVMPointerType(LLVMInt8TypeInContext(gen->context), 0);
+    LLVMValueRef elemsize = LLVMConstInt(usize, LLVMABISizeOfType(gen->datalayout, LLVMTypeOf(fillval)), 0);
+    unsigned align = LLVMABIAlignmentOfType(gen->datalayout, LLVMTypeOf(fillval));
+    LLVMValueRef bytesp = LLVMBuildBitCast(gen->builder, valuep, bytep, "");
+
+    int byte = genlSplatByte(fillval);
+    if (byte >= 0) {
+        LLVMValueRef byteval = LLVMConstInt(LLVMInt8TypeInContext(gen->context), byte, 0);
+        LLVMBuildMemSet(gen->builder, bytesp, byteval, LLVMBuildMul(gen->builder, nbrelems, elemsize, ""), align);
+        return;
+    }
+
+    LLVMValueRef donephis[2];
     LLVMBasicBlockRef phiblks[2];
 
     // Set up blocks for the upcoming loop
     LLVMBasicBlockRef loopend = genlInsertBlock(gen, "fillloopend");
     LLVMBasicBlockRef loopbody = genlInsertBlock(gen, "fillloopbody");
     LLVMBasicBlockRef loopbeg = genlInsertBlock(gen, "fillloopbeg");
-
-    // Finish out current block
-    LLVMValueRef fillval = genlExpr(gen, nodesGet(arraylit->elems, 0));
-    ptrphis[0] = valuep;
-    cntphis[0] = nbrelems;
-    phiblks[0] = LLVMGetInsertBlock(gen->builder);
+    LLVMBasicBlockRef firstblk = genlInsertBlock(gen, "fillfirst");
+
+    // Store first element (if any)
+    LLVMValueRef constzero = LLVMConstInt(usize, 0, 0);
+    LLVMBuildCondBr(gen->builder, LLVMBuildICmp(gen->builder, LLVMIntEQ, nbrelems, constzero, ""), loopend, firstblk);
+    LLVMPositionBuilderAtEnd(gen->builder, firstblk);
+    LLVMBuildStore(gen->builder, fillval, valuep);
+    donephis[0] = LLVMConstInt(usize, 1, 0);
+    phiblks[0] = firstblk;
     LLVMBuildBr(gen->builder, loopbeg);
 
     // Code for the beginning of the loop: the exit comparison
     LLVMPositionBuilderAtEnd(gen->builder, loopbeg);
-    LLVMValueRef loopptrphi = LLVMBuildPhi(gen->builder, LLVMTypeOf(valuep), "ptrphi");
-    LLVMValueRef loopcntphi = LLVMBuildPhi(gen->builder, LLVMTypeOf(nbrelems), "cntphi");
-    LLVMValueRef constzero = LLVMConstInt(LLVMTypeOf(loopcntphi), 0, 1);
-    LLVMValueRef condbool = LLVMBuildICmp(gen->builder, LLVMIntEQ, loopcntphi, constzero, "");
+    LLVMValueRef donephi = LLVMBuildPhi(gen->builder, usize, "donephi");
+    LLVMValueRef condbool = LLVMBuildICmp(gen->builder, LLVMIntUGE, donephi, nbrelems, "");
     LLVMBuildCondBr(gen->builder, condbool, loopend, loopbody);
 
-    // Store value, increment pointer and decrement counter
+    // Copy min(done, left) elements from the start to the end of the filled part
     LLVMPositionBuilderAtEnd(gen->builder, loopbody);
-    LLVMBuildStore(gen->builder, fillval, loopptrphi);
-    LLVMValueRef constone = LLVMConstInt(genlType(gen, (INode*)usizeType), 1, 1);
-    ptrphis[1] = LLVMBuildGEP(gen->builder, loopptrphi, &constone, 1, "");
-    cntphis[1] = LLVMBuildSub(gen->builder, loopcntphi, constone, "");
+    LLVMValueRef left = LLVMBuildSub(gen->builder, nbrelems, donephi, "");
+    LLVMValueRef chunk = LLVMBuildSelect(gen->builder,
+        LLVMBuildICmp(gen->builder, LLVMIntULT, donephi, left, ""), donephi, left, "");
+    LLVMValueRef destp = LLVMBuildBitCast(gen->builder, LLVMBuildGEP(gen->builder, valuep, &donephi, 1, ""), bytep, "");
+    LLVMBuildMemCpy(gen->builder, destp, align, bytesp, align, LLVMBuildMul(gen->builder, chunk, elemsize, ""));
+    donephis[1] = LLVMBuildAdd(gen->builder, donephi, chunk, "");
     phiblks[1] = loopbody;
     LLVMBuildBr(gen->builder, loopbeg);
 
-    LLVMAddIncoming(loopptrphi, ptrphis, phiblks, 2);
-    LLVMAddIncoming(loopcntphi, cntphis, phiblks, 2);
+    LLVMAddIncoming(donephi, donephis, phiblks, 2);
     LLVMPositionBuilderAtEnd(gen->builder, loopend);
 }
 
+// Declare a thread-local pointer defined by the runtime (see conestd/arena.c)
+LLVMValueRef genlArenaGlobal(GenState *gen, char *name) {
+    LLVMValueRef global = LLVMAddGlobal(gen->module, LLVMPointerType(LLVMInt8TypeInContext(gen->context), 0), name);
+    LLVMSetThreadLocal(global, 1);
+    return global;
+}
+
+// Allocate from the arena region: bump the thread's pointer into its current chunk,
+// only calling the region's _alloc (for a new chunk) when the chunk lacks room
+LLVMValueRef genlArenaAlloc(GenState *gen, INode *region, LLVMValueRef sizeval) {
+    LLVMTypeRef usize = genlType(gen, (INode*)usizeType);
+    if (gen->arenanext == NULL) {
+        gen->arenanext = genlArenaGlobal(gen, "arenaNext");
+        gen->arenaend = genlArenaGlobal(gen, "arenaEnd");
+    }
+
+    // Keep every allocation 16-byte aligned
+    sizeval = LLVMBuildAnd(gen->builder,
+        LLVMBuildAdd(gen->builder, sizeval, LLVMConstInt(usize, 15, 0), ""),
+        LLVMConstInt(usize, ~(unsigned long long)15, 0), "arenasize");
+
+    // Does it fit in what is left of the current chunk?
+    LLVMValueRef next = LLVMBuildLoad(gen->builder, gen->arenanext, "arenanext");
+    LLVMValueRef end = LLVMBuildLoad(gen->builder, gen->arenaend, "arenaend");
+    LLVMValueRef avail = LLVMBuildSub(gen->builder, LLVMBuildPtrToInt(gen->builder, end, usize, ""),
+        LLVMBuildPtrToInt(gen->builder, next, usize, ""), "arenaavail");
+    LLVMValueRef fits = LLVMBuildICmp(gen->builder, LLVMIntULE, sizeval, avail, "arenafits");
+    LLVMBasicBlockRef bumpblk = genlInsertBlock(gen, "arenabump");
+    LLVMBasicBlockRef chunkblk = genlInsertBlock(gen, "arenachunk");
+    LLVMBasicBlockRef doneblk = genlInsertBlock(gen, "arenadone");
+    LLVMBuildCondBr(gen->builder, fits, bumpblk, chunkblk);
+
+    LLVMValueRef ptrs[2];
+    LLVMBasicBlockRef blks[2];
+    LLVMPositionBuilderAtEnd(gen->builder, bumpblk);
+    LLVMBuildStore(gen->builder, LLVMBuildGEP(gen->builder, next, &sizeval, 1, ""), gen->arenanext);
+    ptrs[0] = next;
+    blks[0] = bumpblk;
+    LLVMBuildBr(gen->builder, doneblk);
+
+    LLVMPositionBuilderAtEnd(gen->builder, chunkblk);
+    FnDclNode *allocmeth = (FnDclNode*)iTypeFindFnField(region, allocMethodName);
+    ptrs[1] = genlFnCallInternal(gen, SimpleDispatch, (INode*)allocmeth, 1, &sizeval);
+    blks[1] = LLVMGetInsertBlock(gen->builder);
+    LLVMBuildBr(gen->builder, doneblk);
+
+    LLVMPositionBuilderAtEnd(gen->builder, doneblk);
+    LLVMValueRef phi = LLVMBuildPhi(gen->builder, LLVMTypeOf(next), "arenaptr");
+    LLVMAddIncoming(phi, ptrs, blks, 2);
+    return phi;
+}
+
 // Generate region-based allocation and initialization logc
 // It returns a reference to the allocated/initialized object (or null)
 // This is roughly what it does:
@@ -147,7 +280,7 @@ LLVMValueRef genlallocref(GenState *gen, RefNode *allocatenode) {
     }
     INode *region = iTypeGetTypeDcl(reftype->region);
     INode *perm = iTypeGetTypeDcl(reftype->perm);
-    LLVMTypeRef valuetypllvm = LLVMStructGetTypeAtIndex(LLVMGetElementType(reftype->typeinfo->ptrstructype), ValueField);
+    LLVMTypeRef valuetypllvm = LLVMStructGetTypeAtIndex(reftype->typeinfo->structype, reftype->typeinfo->valuefield);
     LLVMTypeRef valueptrtyp = LLVMPointerType(valuetypllvm, 0);
 
     // Calculate how much memory space we need to allocate
@@ -160,7 +293,7 @@ LLVMValueRef genlallocref(GenState *gen, RefNode *allocatenode) {
         if (initvalue->dimens->used > 0)
             nbrelems = genlExpr(gen, nodesGet(initvalue->dimens, 0));
         else
-            nbrelems = LLVMConstInt(genlType(gen, (INode*)usizeType), initvalue->elems->used, 0);
+            nbrelems = LLVMConstInt(genlType(gen, (INode*)usizeType), arrayLitCount(initvalue), 0);
         LLVMValueRef constone = LLVMConstInt(genlType(gen, (INode*)usizeType), 1, 0);
         LLVMValueRef nbrelemsdec = LLVMBuildSub(gen->builder, nbrelems, constone, "");
         LLVMValueRef elemsz = LLVMConstInt(genlType(gen, (INode*)usizeType), LLVMABISizeOfType(gen->datalayout, valuetypllvm), 0);
@@ -169,8 +302,17 @@ LLVMValueRef genlallocref(GenState *gen, RefNode *allocatenode) {
     }
 
     // Do region allocation (using its _alloc method) and then bitcast to multi-layered-struct ptr
-    FnDclNode *allocmeth = (FnDclNode*)iTypeFindFnField(region, allocMethodName);
-    LLVMValueRef malloc = genlFnCallInternal(gen, SimpleDispatch, (INode*)allocmeth, 1, &sizeval);
+    // Fixed-size so/rc allocations bypass _alloc, going straight to their size class's pool
+    LLVMValueRef malloc;
+    int sizeclass = genlPoolClass(gen, reftype);
+    if (sizeclass >= 0)
+        malloc = genlPoolCall(gen, gen->poolallocfn, "poolAlloc", sizeclass, NULL);
+    else if (isRegion(region, arenaName))
+        malloc = genlArenaAlloc(gen, region, sizeval);
+    else {
+        FnDclNode *allocmeth = (FnDclNode*)iTypeFindFnField(region, allocMethodName);
+        malloc = genlFnCallInternal(gen, SimpleDispatch, (INode*)allocmeth, 1, &sizeval);
+    }
     LLVMValueRef ptrstructype = LLVMBuildBitCast(gen->builder, malloc, reftype->typeinfo->ptrstructype, "");
 
     // Handle when allocation fails (returns NULL pointer)
@@ -198,30 +340,30 @@ LLVMValueRef genlallocref(GenState *gen, RefNode *allocatenode) {
 
     // Initialize region using its 'init' method, if supplied
     INode *reginitmeth = iTypeFindFnField(region, initMethodName);
-    if (reginitmeth) {
+    if (reginitmeth && reftype->typeinfo->regionfield >= 0) {
         LLVMValueRef initval = genlFnCallInternal(gen, SimpleDispatch, (INode*)reginitmeth, 0, NULL);
-        LLVMValueRef regionp = LLVMBuildStructGEP(gen->builder, ptrstructype, 0, "region");
+        LLVMValueRef regionp = LLVMBuildStructGEP(gen->builder, ptrstructype, reftype->typeinfo->regionfield, "region");
         LLVMBuildStore(gen->builder, initval, regionp);
     }
 
     // Initialize permission, if it is a locked permission with an init method
     if (perm->tag == StructTag) {
         INode *perminitmeth = iTypeFindFnField(perm, initMethodName);
-        if (perminitmeth) {
+        if (perminitmeth && reftype->typeinfo->permfield >= 0) {
             LLVMValueRef initval = genlFnCallInternal(gen, SimpleDispatch, (INode*)perminitmeth, 0, NULL);
-            LLVMValueRef permp = LLVMBuildStructGEP(gen->builder, ptrstructype, 1, "perm");
+            LLVMValueRef permp = LLVMBuildStructGEP(gen->builder, ptrstructype, reftype->typeinfo->permfield, "perm");
             LLVMBuildStore(gen->builder, initval, permp);
         }
     }
 
     // Initialize value (via copy or init function) and return pointer to it
-    LLVMValueRef valuep = LLVMBuildStructGEP(gen->builder, ptrstructype, ValueField, ""); // Point to value
+    LLVMValueRef valuep = LLVMBuildStructGEP(gen->builder, ptrstructype, reftype->typeinfo->valuefield, ""); // Point to value
     if (reftype->tag == RefTag) {
-        LLVMBuildStore(gen->builder, genlExpr(gen, allocatenode->vtexp), valuep); // Copy value
+        genlStoreValue(gen, genlExpr(gen, allocatenode->vtexp), valuep); // Copy value
     }
     else {
         // Handle array fill via run-time generation
-        if (allocatenode->vtexp->tag == ArrayLitTag && ((ArrayNode*)allocatenode->vtexp)->dimens > 0) {
+        if (allocatenode->vtexp->tag == ArrayLitTag && ((ArrayNode*)allocatenode->vtexp)->dimens->used > 0) {
             genlAllocFillArray(gen, nbrelems, (ArrayNode*)allocatenode->vtexp, valuep);
         }
         else {
@@ -229,7 +371,7 @@ LLVMValueRef genlallocref(GenState *gen, RefNode *allocatenode) {
             LLVMValueRef initval = genlExpr(gen, allocatenode->vtexp);
             LLVMTypeRef initvaltype = LLVMPointerType(LLVMTypeOf(initval), 0);
             LLVMValueRef valuepcast = LLVMBuildBitCast(gen->builder, valuep, initvaltype, "");
-            LLVMBuildStore(gen->builder, initval, valuepcast);
+            genlStoreValue(gen, initval, valuepcast);
         }
 
         // Build fat pointer for returning
@@ -251,32 +393,76 @@ LLVMValueRef genlallocref(GenState *gen, RefNode *allocatenode) {
 // Dealias an own allocated reference
 void genlDealiasOwn(GenState *gen, LLVMValueRef ref, RefNode *refnode) {
     genlDealiasFlds(gen, ref, refnode);
-    genlFree(gen, ref);
+    genlFree(gen, genlRefAllocStart(gen, ref, refnode), refnode);
+}
+
+// Count an executed rc/arc counter update in the runtime's rcOpCount (see conestd/rccount.c).
+// The first use also makes rcOpCountStart a module constructor, which prints the count at exit.
+void genlRcOpCount(GenState *gen) {
+    LLVMTypeRef u64 = LLVMInt64TypeInContext(gen->context);
+    if (gen->rcopcount == NULL) {
+        gen->rcopcount = LLVMAddGlobal(gen->module, u64, "rcOpCount");
+        LLVMTypeRef starttype = LLVMFunctionType(LLVMVoidTypeInContext(gen->context), NULL, 0, 0);
+        LLVMValueRef startfn = LLVMAddFunction(gen->module, "rcOpCountStart", starttype);
+        LLVMTypeRef ctorfld[3] = {LLVMInt32TypeInContext(gen->context), LLVMPointerType(starttype, 0),
+            LLVMPointerType(LLVMInt8TypeInContext(gen->context), 0)};
+        LLVMTypeRef ctortype = LLVMStructTypeInContext(gen->context, ctorfld, 3, 0);
+        LLVMValueRef ctorval[3] = {LLVMConstInt(ctorfld[0], 65535, 0), startfn, LLVMConstNull(ctorfld[2])};
+        LLVMValueRef ctor = LLVMConstNamedStruct(ctortype, ctorval, 3);
+        LLVMValueRef ctors = LLVMAddGlobal(gen->module, LLVMArrayType(ctortype, 1), "llvm.global_ctors");
+        LLVMSetLinkage(ctors, LLVMAppendingLinkage);
+        LLVMSetInitializer(ctors, LLVMConstArray(ctortype, &ctor, 1));
+    }
+    LLVMBuildAtomicRMW(gen->builder, LLVMAtomicRMWBinOpAdd, gen->rcopcount, LLVMConstInt(u64, 1, 0),
+        LLVMAtomicOrderingMonotonic, 0);
 }
 
-// Add to the counter of an rc allocated reference
+// Add to the counter of an rc or arc allocated reference
 void genlRcCounter(GenState *gen, LLVMValueRef ref, long long amount, RefNode *refnode) {
-    // Point backwards to ref counter
-    LLVMTypeRef ptrusize = LLVMPointerType(genlType(gen, (INode*)usizeType), 0);
-    LLVMValueRef refcast = LLVMBuildBitCast(gen->builder, ref, ptrusize, "");
-    LLVMValueRef minusone = LLVMConstInt(genlType(gen, (INode*)usizeType), -1, 1);
-    LLVMValueRef cntptr = LLVMBuildGEP(gen->builder, refcast, &minusone, 1, "");
-
-    // Increment ref counter
-    LLVMValueRef cnt = LLVMBuildLoad(gen->builder, cntptr, "");
-    LLVMTypeRef usize = genlType(gen, (INode*)usizeType);
-    LLVMValueRef newcnt = LLVMBuildAdd(gen->builder, cnt, LLVMConstInt(usize, amount, 0), "");
-    LLVMBuildStore(gen->builder, newcnt, cntptr);
+    if (gen->opt->rc_count)
+        genlRcOpCount(gen);
+
+    // Point backwards to ref counter, the region's only field (usize, or u32 with --rc32)
+    RefTypeInfo *refinfo = refnode->typeinfo;
+    LLVMTypeRef cnttype = LLVMStructGetTypeAtIndex(genlType(gen, refnode->region), 0);
+    LLVMValueRef allocstart = genlRefAllocStart(gen, ref, refnode);
+    LLVMValueRef cntptr = allocstart;
+    unsigned long long cntoffset = LLVMOffsetOfElement(gen->datalayout, refinfo->structype, refinfo->regionfield);
+    if (cntoffset > 0) {
+        LLVMValueRef fwd = LLVMConstInt(genlType(gen, (INode*)usizeType), cntoffset, 0);
+        cntptr = LLVMBuildGEP(gen->builder, cntptr, &fwd, 1, "");
+    }
+    cntptr = LLVMBuildBitCast(gen->builder, cntptr, LLVMPointerType(cnttype, 0), "");
+
+    // Increment ref counter. rc references stay in their thread, so a plain load/add/store is enough.
+    // arc's counter is updated atomically: increments need no ordering, but a decrement
+    // must release this thread's writes to whichever thread ends up freeing the object.
+    LLVMValueRef amountval = LLVMConstInt(cnttype, amount, 0);
+    LLVMValueRef newcnt;
+    int isatomic = isRegion(refnode->region, arcName);
+    if (isatomic) {
+        LLVMValueRef cnt = LLVMBuildAtomicRMW(gen->builder, LLVMAtomicRMWBinOpAdd, cntptr, amountval,
+            amount < 0 ? LLVMAtomicOrderingRelease : LLVMAtomicOrderingMonotonic, 0);
+        newcnt = LLVMBuildAdd(gen->builder, cnt, amountval, "");
+    }
+    else {
+        LLVMValueRef cnt = LLVMBuildLoad(gen->builder, cntptr, "");
+        newcnt = LLVMBuildAdd(gen->builder, cnt, amountval, "");
+        LLVMBuildStore(gen->builder, newcnt, cntptr);
+    }
 
     // Free if zero. Otherwise, don't
     if (amount < 0) {
         LLVMBasicBlockRef nofree = genlInsertBlock(gen, "nofree");
         LLVMBasicBlockRef dofree = genlInsertBlock(gen, "free");
-        LLVMValueRef test = LLVMBuildICmp(gen->builder, LLVMIntEQ, newcnt, LLVMConstInt(usize, 0, 0), "iszero");
+        LLVMValueRef test = LLVMBuildICmp(gen->builder, LLVMIntEQ, newcnt, LLVMConstInt(cnttype, 0, 0), "iszero");
         LLVMBuildCondBr(gen->builder, test, dofree, nofree);
         LLVMPositionBuilderAtEnd(gen->builder, dofree);
+        // Acquire all other threads' released writes before tearing down the object
+        if (isatomic)
+            LLVMBuildFence(gen->builder, LLVMAtomicOrderingAcquire, 0, "");
         genlDealiasFlds(gen, ref, refnode);
-        genlFree(gen, cntptr);
+        genlFree(gen, allocstart, refnode);
         LLVMBuildBr(gen->builder, nofree);
         LLVMPositionBuilderAtEnd(gen->builder, nofree);
     }
@@ -296,7 +482,7 @@ void genlDealiasNodes(GenState *gen, Nodes *nodes) {
             if (isRegion(reftype->region, soName)) {
                 genlDealiasOwn(gen, ref, reftype);
             }
-            else if (isRegion(reftype->region, rcName)) {
+            else if (isRcRegion(reftype->region)) {
                 genlRcCounter(gen, ref, -1, reftype);
             }
         }
@@ -600,7 +600,9 @@ LLVMValueRef genlLocalVar(GenState *gen, VarDclNode *var) {
     var->llvmvar = genlAlloca(gen, genlType(gen, var->vtype), &var->namesym->namestr);
     if (var->value) {
         val = genlExpr(gen, var->value);
-        LLVMBuildStore(gen->builder, val, var->llvmvar);
+        LLVMValueRef store = genlStoreValue(gen, val, var->llvmvar);
+        if (store)
+            genlTbaa(gen, store, var->vtype);
     }
     return val;
 }
@@ -676,18 +678,144 @@ void genlPanic(GenState *gen) {
     LLVMBuildCall(gen->builder, fn, NULL, 0, "");
 }
 
-void genlBoundsCheck(GenState *gen, LLVMValueRef index, LLVMValueRef count) {
+// Tell LLVM that cond is known to be true
+void genlAssume(GenState *gen, LLVMValueRef cond) {
+    char *fnname = "llvm.assume";
+    LLVMValueRef fn = LLVMGetNamedFunction(gen->module, fnname);
+    if (!fn) {
+        LLVMTypeRef parmtype = LLVMInt1TypeInContext(gen->context);
+        LLVMTypeRef fnsig = LLVMFunctionType(LLVMVoidTypeInContext(gen->context), &parmtype, 1, 0);
+        fn = LLVMAddFunction(gen->module, fnname, fnsig);
+    }
+    LLVMBuildCall(gen->builder, fn, &cond, 1, "");
+}
+
+// Ensure index < count, or panic. Since panic never returns, LLVM may assume
+// index < count afterwards, letting it drop or hoist later checks on the same index.
+// If not NULL, inrange is a flag computed before the loop: when true, no check is needed.
+void genlBoundsCheck(GenState *gen, LLVMValueRef index, LLVMValueRef count, LLVMValueRef inrange) {
+    // A constant index within a constant count needs no check
+    if (LLVMIsAConstantInt(index) && LLVMIsAConstantInt(count)
+        && LLVMConstIntGetZExtValue(index) < LLVMConstIntGetZExtValue(count))
+        return;
+
+    if (gen->opt->unchecked_bounds) {
+        genlAssume(gen, LLVMBuildICmp(gen->builder, LLVMIntULT, index, count, ""));
+        return;
+    }
+
+    // Skip the check when the loop's range was found to be in bounds before it started.
+    // That condition is loop-invariant, so LLVM can unswitch the loop on it.
+    LLVMBasicBlockRef boundsblk = genlInsertBlock(gen, "boundsok");
+    if (inrange) {
+        LLVMBasicBlockRef checkblk = genlInsertBlock(gen, "boundschk");
+        LLVMBuildCondBr(gen->builder, inrange, boundsblk, checkblk);
+        LLVMPositionBuilderAtEnd(gen->builder, checkblk);
+    }
+
     // Do runtime bounds check and panic
     LLVMBasicBlockRef panicblk = genlInsertBlock(gen, "panic");
-    LLVMBasicBlockRef boundsblk = genlInsertBlock(gen, "boundsok");
     LLVMValueRef compare = LLVMBuildICmp(gen->builder, LLVMIntULT, index, count, "");
     LLVMBuildCondBr(gen->builder, compare, boundsblk, panicblk);
     LLVMPositionBuilderAtEnd(gen->builder, panicblk);
     genlPanic(gen);
-    LLVMBuildBr(gen->builder, boundsblk);
+    LLVMBuildUnreachable(gen->builder);
     LLVMPositionBuilderAtEnd(gen->builder, boundsblk);
 }
 
+// If index is an unmutated 'each' range variable, return its declaration.
+// Unsigned conversions of the variable are fine, as they never increase its value.
+VarDclNode *genlRangeVar(INode *index) {
+    while (index->tag == CastTag && iexpGetTypeDcl(index)->tag == UintNbrTag)
+        index = ((CastNode *)index)->exp;
+    if (index->tag != VarNameUseTag)
+        return NULL;
+    VarDclNode *vardcl = (VarDclNode *)((NameUseNode *)index)->dclnode;
+    if (vardcl->tag != VarDclTag || vardcl->rangelimit == NULL
+        || iTypeGetTypeDcl(vardcl->vtype)->tag != UintNbrTag)
+        return NULL;
+    return vardcl;
+}
+
+// Is index an 'each' range variable whose loop keeps it below a constant count?
+// e.g., 'each i in 0 < 10 {a[i]}' where a is an array of 10 or more elements.
+int genlIndexInRange(INode *index, uint64_t count) {
+    VarDclNode *rangevar = genlRangeVar(index);
+    if (rangevar == NULL || rangevar->rangelimit->tag != ULitTag)
+        return 0;
+    uint64_t limit = ((ULitNode *)rangevar->rangelimit)->uintlit;
+    return rangevar->flowflags & VarRangeIncl ? limit < count : limit <= count;
+}
+
+// If node is 'arr.len', return arr. Otherwise, return NULL.
+INode *genlLenOf(INode *node) {
+    if (node->tag != FnCallTag)
+        return NULL;
+    FnCallNode *fncall = (FnCallNode *)node;
+    if (fncall->objfn->tag != VarNameUseTag || fncall->args == NULL || fncall->args->used != 1)
+        return NULL;
+    FnDclNode *fndcl = (FnDclNode *)((NameUseNode *)fncall->objfn)->dclnode;
+    if (fndcl->tag != FnDclTag || fndcl->value == NULL || fndcl->value->tag != IntrinsicTag
+        || ((IntrinsicNode *)fndcl->value)->intrinsicFn != CountIntrinsic)
+        return NULL;
+    return nodesGet(fncall->args, 0);
+}
+
+// Does node have the same value throughout a loop whose variables are declared at 'scope'?
+// Only constants, imm variables declared outside the loop and their lengths qualify.
+int genlIsInvariant(INode *node, uint16_t scope) {
+    switch (node->tag) {
+    case ULitTag:
+        return 1;
+    case VarNameUseTag: {
+        VarDclNode *vardcl = (VarDclNode *)((NameUseNode *)node)->dclnode;
+        return vardcl->tag == ConstDclTag
+            || (vardcl->tag == VarDclTag && vardcl->scope < scope
+                && iTypeGetTypeDcl(vardcl->perm) == (INode*)immPerm);
+    }
+    case FnCallTag: {
+        INode *arr = genlLenOf(node);
+        return arr && genlIsInvariant(arr, scope);
+    }
+    default:
+        return 0;
+    }
+}
+
+// Check once, before an 'each' loop starts, whether its range variable stays below count
+// (the length of arrref, or a constant) for the whole loop. Returns the flag, which is
+// true if the loop never runs or its limit is within count. Returns NULL if the check
+// cannot be hoisted, because the limit or arrref may change inside the loop.
+LLVMValueRef genlHoistRangeCheck(GenState *gen, VarDclNode *rangevar, INode *arrref, LLVMValueRef count) {
+    INode *limitnode = rangevar->rangelimit;
+    if (!genlIsInvariant(limitnode, rangevar->scope) || (arrref && !genlIsInvariant(arrref, rangevar->scope)))
+        return NULL;
+    LLVMTypeRef usize = genlUsize(gen);
+    LLVMTypeRef vartype = genlType(gen, rangevar->vtype);
+    LLVMTypeRef limittype = genlType(gen, ((IExpNode *)limitnode)->vtype);
+    if (LLVMGetIntTypeWidth(vartype) > LLVMGetIntTypeWidth(usize)
+        || LLVMGetIntTypeWidth(limittype) > LLVMGetIntTypeWidth(usize))
+        return NULL;
+    GenBlockState *loopstate = genFindBlockState(gen, (BlockNode *)rangevar->rangeloop);
+    if (loopstate == NULL)
+        return NULL;
+
+    // Generate the check at the end of the loop's preheader, where the
+    // range variable still holds its starting value
+    LLVMBasicBlockRef curblk = LLVMGetInsertBlock(gen->builder);
+    LLVMPositionBuilderBefore(gen->builder, LLVMGetBasicBlockTerminator(loopstate->preheader));
+    if (arrref)
+        count = LLVMBuildExtractValue(gen->builder, genlExpr(gen, arrref), 1, "count");
+    LLVMValueRef start = LLVMBuildZExt(gen->builder, LLVMBuildLoad(gen->builder, rangevar->llvmvar, ""), usize, "");
+    LLVMValueRef limit = LLVMBuildZExt(gen->builder, genlExpr(gen, limitnode), usize, "");
+    int incl = rangevar->flowflags & VarRangeIncl;
+    LLVMValueRef norun = LLVMBuildICmp(gen->builder, incl ? LLVMIntUGT : LLVMIntUGE, start, limit, "");
+    LLVMValueRef within = LLVMBuildICmp(gen->builder, incl ? LLVMIntULT : LLVMIntULE, limit, count, "");
+    LLVMValueRef inrange = LLVMBuildOr(gen->builder, norun, within, "inrange");
+    LLVMPositionBuilderAtEnd(gen->builder, curblk);
+    return inrange;
+}
+
 LLVMValueRef genlArrayIndex(GenState *gen, FnCallNode *fncall, ArrayNode *objtype) {
     // Allocate a indexing buffer for GEP
     LLVMValueRef indexes[2];
@@ -701,14 +829,65 @@ LLVMValueRef genlArrayIndex(GenState *gen, FnCallNode *fncall, ArrayNode *objtyp
     for (int arg = 0; arg < nindex; arg++) {
         ULitNode *dimen = (ULitNode*)nodesGet(objtype->dimens, arg);
         assert(dimen->tag == ULitTag);
-        LLVMValueRef count = LLVMConstInt(genlUsize(gen), dimen->uintlit, 0);
-        LLVMValueRef index = genlExpr(gen, nodesGet(fncall->args, arg));
-        genlBoundsCheck(gen, index, count);
+        INode *argnode = nodesGet(fncall->args, arg);
+        LLVMValueRef index = genlExpr(gen, argnode);
+        if (!genlIndexInRange(argnode, dimen->uintlit)) {
+            LLVMValueRef count = LLVMConstInt(genlUsize(gen), dimen->uintlit, 0);
+            VarDclNode *rangevar = genlRangeVar(argnode);
+            LLVMValueRef inrange = rangevar ? genlHoistRangeCheck(gen, rangevar, NULL, count) : NULL;
+            genlBoundsCheck(gen, index, count, inrange);
+        }
         indexp[arg+1] = index;
     }
     return LLVMBuildGEP(gen->builder, genlAddr(gen, fncall->objfn), indexp, nindex+1, "");
 }
 
+// Does the range variable's loop stop it before arrref.len (an invariant slice variable)?
+int genlRangeIsLenOf(VarDclNode *rangevar, INode *arrref) {
+    if ((rangevar->flowflags & VarRangeIncl) || arrref->tag != VarNameUseTag
+        || !genlIsInvariant(arrref, rangevar->scope))
+        return 0;
+    INode *lenof = genlLenOf(rangevar->rangelimit);
+    return lenof && lenof->tag == VarNameUseTag
+        && ((NameUseNode *)lenof)->dclnode == ((NameUseNode *)arrref)->dclnode;
+}
+
+// Generate a pointer to the indexed element of an array reference (slice)
+LLVMValueRef genlSliceIndex(GenState *gen, INode *arrref, INode *indexnode) {
+    LLVMValueRef arrval = genlExpr(gen, arrref);
+    LLVMValueRef index = genlExpr(gen, indexnode);
+
+    // Indexing by an 'each' range variable needs no check if its loop
+    // runs to the slice's own len, else its check may be hoisted before the loop
+    VarDclNode *rangevar = genlRangeVar(indexnode);
+    if (rangevar == NULL || !genlRangeIsLenOf(rangevar, arrref)) {
+        LLVMValueRef count = LLVMBuildExtractValue(gen->builder, arrval, 1, "count");
+        LLVMValueRef inrange = rangevar ? genlHoistRangeCheck(gen, rangevar, arrref, NULL) : NULL;
+        genlBoundsCheck(gen, index, count, inrange);
+    }
+    LLVMValueRef sliceptr = LLVMBuildExtractValue(gen->builder, arrval, 0, "sliceptr");
+    return LLVMBuildGEP(gen->builder, sliceptr, &index, 1, "");
+}
+
+// Is this value already in memory (through a reference, pointer or array element),
+// so that one of its fields can be loaded without loading the whole value?
+int genlIsMemLval(INode *lval) {
+    switch (lval->tag) {
+    case DerefTag:
+        return 1;
+    case ArrIndexTag:
+        return !(lval->flags & FlagBorrow);
+    case FldAccessTag:
+    {
+        FnCallNode *fncall = (FnCallNode *)lval;
+        return !(lval->flags & FlagBorrow) && iexpGetTypeDcl(fncall->objfn)->tag != VirtRefTag
+            && genlIsMemLval(fncall->objfn);
+    }
+    default:
+        return 0;
+    }
+}
+
 // Generate an lval-ish pointer to the value (vs. load)
 LLVMValueRef genlAddr(GenState *gen, INode *lval) {
     switch (lval->tag) {
@@ -728,23 +907,12 @@ LLVMValueRef genlAddr(GenState *gen, INode *lval) {
         case ArrayTag: {
             return genlArrayIndex(gen, fncall, (ArrayNode*)objtype);
         }
-        case ArrayRefTag: {
-            LLVMValueRef arrref = genlExpr(gen, fncall->objfn);
-            LLVMValueRef count = LLVMBuildExtractValue(gen->builder, arrref, 1, "count");
-            LLVMValueRef index = genlExpr(gen, nodesGet(fncall->args, 0));
-            genlBoundsCheck(gen, index, count);
-            LLVMValueRef sliceptr = LLVMBuildExtractValue(gen->builder, arrref, 0, "sliceptr");
-            return LLVMBuildGEP(gen->builder, sliceptr, &index, 1, "");
-        }
+        case ArrayRefTag:
+            return genlSliceIndex(gen, fncall->objfn, nodesGet(fncall->args, 0));
         case ArrayDerefTag: {
             StarNode *deref = (StarNode *)fncall->objfn;
             assert(deref->tag == DerefTag);
-            LLVMValueRef arrref = genlExpr(gen, deref->vtexp);
-            LLVMValueRef count = LLVMBuildExtractValue(gen->builder, arrref, 1, "count");
-            LLVMValueRef index = genlExpr(gen, nodesGet(fncall->args, 0));
-            genlBoundsCheck(gen, index, count);
-            LLVMValueRef sliceptr = LLVMBuildExtractValue(gen->builder, arrref, 0, "sliceptr");
-            return LLVMBuildGEP(gen->builder, sliceptr, &index, 1, "");
+            return genlSliceIndex(gen, deref->vtexp, nodesGet(fncall->args, 0));
         }
         case PtrTag: {
             LLVMValueRef index = genlExpr(gen, nodesGet(fncall->args, 0));
@@ -787,7 +955,7 @@ LLVMValueRef genlAddr(GenState *gen, INode *lval) {
             // So we hack it by storing in an unnamed local variable and return that address
             // This is particularly necessary when doing an array index ([1,2,5][n])  (LLVM fail at this too)
             LLVMValueRef temparray = genlAlloca(gen, genlType(gen, type), "temparray");
-            LLVMBuildStore(gen->builder, genlExpr(gen, lval), temparray);
+            genlStoreValue(gen, genlExpr(gen, lval), temparray);
             return temparray;
         }
         assert(0 && "Cannot get address of this node");
@@ -796,21 +964,135 @@ LLVMValueRef genlAddr(GenState *gen, INode *lval) {
     }
 }
 
+// Return the byte every byte of a constant value is, or -1 if they differ (or it is not constant)
+int genlSplatByte(LLVMValueRef val) {
+    if (!LLVMIsConstant(val))
+        return -1;
+    if (LLVMIsNull(val))
+        return 0;
+    if (LLVMIsAConstantInt(val)) {
+        unsigned bits = LLVMGetIntTypeWidth(LLVMTypeOf(val));
+        if (bits % 8 != 0 || bits > 64)
+            return -1;
+        unsigned long long intval = LLVMConstIntGetZExtValue(val);
+        int byte = (int)(intval & 0xFF);
+        for (unsigned shift = 8; shift < bits; shift += 8) {
+            if ((int)((intval >> shift) & 0xFF) != byte)
+                return -1;
+        }
+        return byte;
+    }
+
+    // Constant arrays/structs: all elements must splat the same byte
+    // (Note: struct padding bytes are left undefined, so any value is fine for them)
+    unsigned nelems;
+    int isdata = LLVMIsAConstantDataSequential(val) != NULL;
+    if (isdata)
+        nelems = LLVMGetArrayLength(LLVMTypeOf(val));
+    else if (LLVMIsAConstantArray(val) || LLVMIsAConstantStruct(val))
+        nelems = LLVMGetNumOperands(val);
+    else
+        return -1;
+    int byte = -1;
+    for (unsigned i = 0; i < nelems; ++i) {
+        int elembyte = genlSplatByte(isdata ? LLVMGetElementAsConstant(val, i) : LLVMGetOperand(val, i));
+        if (elembyte < 0 || (byte >= 0 && elembyte != byte))
+            return -1;
+        byte = elembyte;
+    }
+    return byte;
+}
+
+// Has nothing written to memory since this instruction (in its block)?
+int genlNoWritesSince(LLVMValueRef inst) {
+    while ((inst = LLVMGetNextInstruction(inst))) {
+        if (LLVMIsACallInst(inst) || LLVMIsAStoreInst(inst) || LLVMIsAAtomicRMWInst(inst)
+            || LLVMIsAAtomicCmpXchgInst(inst) || LLVMIsAFenceInst(inst))
+            return 0;
+    }
+    return 1;
+}
+
+// Store a value to memory. Large aggregates are stored using llvm.memset
+// when they are a byte-splat constant (e.g., all zeros), or llvm.memcpy when
+// they were just loaded from memory (e.g., copying one array variable to another).
+LLVMValueRef genlStoreValue(GenState *gen, LLVMValueRef val, LLVMValueRef ptr) {
+    LLVMTypeRef valtype = LLVMTypeOf(val);
+    LLVMTypeKind kind = LLVMGetTypeKind(valtype);
+    if ((kind != LLVMArrayTypeKind && kind != LLVMStructTypeKind)
+        || LLVMABISizeOfType(gen->datalayout, valtype) < GenMemcpyMin)
+        return LLVMBuildStore(gen->builder, val, ptr);
+    LLVMValueRef size = LLVMConstInt(genlUsize(gen), LLVMABISizeOfType(gen->datalayout, valtype), 0);
+    unsigned align = LLVMABIAlignmentOfType(gen->datalayout, valtype);
+
+    int byte = genlSplatByte(val);
+    if (byte >= 0) {
+        LLVMValueRef byteval = LLVMConstInt(LLVMInt8TypeInContext(gen->context), byte, 0);
+        LLVMBuildMemSet(gen->builder, ptr, byteval, size, align);
+    }
+    // Copy straight from where a value was loaded, as long as that memory is unchanged since.
+    // The load is left for any other use of the value; if none, LLVM drops it.
+    else if (LLVMIsALoadInst(val) && LLVMGetInstructionParent(val) == LLVMGetInsertBlock(gen->builder)
+        && genlNoWritesSince(val))
+        LLVMBuildMemCpy(gen->builder, ptr, align, LLVMGetOperand(val, 0), align, size);
+    else
+        return LLVMBuildStore(gen->builder, val, ptr);
+    return NULL;
+}
+
+// Tag a load or store through an lval's address with the lval's TBAA type (or struct path)
+void genlTbaaLval(GenState *gen, LLVMValueRef inst, INode *lval) {
+    if (lval->tag == FldAccessTag) {
+        FnCallNode *fncall = (FnCallNode *)lval;
+        FieldDclNode *flddcl = (FieldDclNode*)((NameUseNode*)fncall->methfld)->dclnode;
+        genlTbaaField(gen, inst, iexpGetTypeDcl(fncall->objfn), flddcl);
+    }
+    else
+        genlTbaa(gen, inst, ((IExpNode*)lval)->vtype);
+}
+
 void genlStore(GenState *gen, INode *lval, LLVMValueRef rval) {
     if (lval->tag == VarNameUseTag && ((NameUseNode*)lval)->namesym == anonName)
         return;
     LLVMValueRef lvalptr = genlAddr(gen, lval);
     RefNode *reftype = (RefNode *)((IExpNode*)lval)->vtype;
-    if (reftype->tag == RefTag && isRegion(reftype->region, rcName))
+    if (reftype->tag == RefTag && isRcRegion(reftype->region))
         genlRcCounter(gen, LLVMBuildLoad(gen->builder, lvalptr, "dealiasref"), -1, reftype);
-    LLVMBuildStore(gen->builder, rval, lvalptr);
+    LLVMValueRef store = genlStoreValue(gen, rval, lvalptr);
+    if (store)
+        genlTbaaLval(gen, store, lval);
+}
+
+// Generate a constant array from an array literal's packed values
+LLVMValueRef genlArrayLitPacked(GenState *gen, ArrayLitPack *pack) {
+    INode *elemtype = arrayLitPackType(pack);
+    LLVMTypeRef llvmelemtype = genlType(gen, elemtype);
+
+    // Byte-sized integers go straight into a constant data array
+    if (pack->littag == ULitTag && ((NbrNode*)elemtype)->bits == 8) {
+        char *data = memAllocBlk(pack->used);
+        for (uint32_t i = 0; i < pack->used; ++i)
+            data[i] = (char)pack->uintlits[i];
+        return LLVMConstStringInContext(gen->context, data, pack->used, 1);
+    }
+
+    LLVMValueRef *values = (LLVMValueRef *)memAllocBlk(pack->used * sizeof(LLVMValueRef));
+    for (uint32_t i = 0; i < pack->used; ++i) {
+        if (pack->littag == ULitTag)
+            values[i] = LLVMConstInt(llvmelemtype, pack->uintlits[i], 0);
+        else
+            values[i] = LLVMConstReal(llvmelemtype, pack->floatlits[i]);
+    }
+    return LLVMConstArray(llvmelemtype, values, pack->used);
 }
 
 // Generate a term
 LLVMValueRef genlExpr(GenState *gen, INode *termnode) {
-    if (!gen->opt->release && gen->fn) {
+    if (!gen->opt->release && gen->fn && termnode->lexer) {
+        char *linep;
+        uint32_t linenbr = lexerLineOf(termnode->lexer, termnode->srcoff, &linep);
         LLVMMetadataRef loc = LLVMDIBuilderCreateDebugLocation(gen->context, 
-            termnode->linenbr, termnode->srcp-termnode->linep, LLVMGetSubprogram(gen->fn), NULL);
+            linenbr, termnode->lexer->source + termnode->srcoff - linep, LLVMGetSubprogram(gen->fn), NULL);
         LLVMValueRef val = LLVMMetadataAsValue(gen->context, loc);
         LLVMSetCurrentDebugLocation(gen->builder, val);
     }
@@ -824,6 +1106,8 @@ LLVMValueRef genlExpr(GenState *gen, INode *termnode) {
     case ArrayLitTag:
     {
         ArrayNode *lit = (ArrayNode *)termnode;
+        if (lit->packed)
+            return genlArrayLitPacked(gen, lit->packed);
         uint32_t size = lit->elems->used;
         if (lit->dimens->used > 0) {
             // When array size specified for fill, use that
@@ -833,10 +1117,14 @@ LLVMValueRef genlExpr(GenState *gen, INode *termnode) {
             assert(dimnode->tag == ULitTag);
             size = (uint32_t)((ULitNode*)dimnode)->uintlit;
         }
+        INode *elemtype = nodesGet(((ArrayNode *) iTypeGetTypeDcl(lit->vtype))->elems, 0);
         LLVMValueRef *values = (LLVMValueRef *)memAllocBlk(size * sizeof(LLVMValueRef *));
         LLVMValueRef *valuep = values;
         if (lit->dimens->used > 0) {
             LLVMValueRef fillval = genlExpr(gen, nodesGet(lit->elems, 0));
+            // A zero fill is just zeroinitializer (which genlStoreValue turns into a memset)
+            if (LLVMIsConstant(fillval) && LLVMIsNull(fillval))
+                return LLVMConstNull(LLVMArrayType(genlType(gen, elemtype), size));
             uint32_t cnt = size;
             while (cnt--)
                 *valuep++ = fillval;
@@ -847,7 +1135,6 @@ LLVMValueRef genlExpr(GenState *gen, INode *termnode) {
             for (nodesFor(lit->elems, cnt, nodesp))
                 *valuep++ = genlExpr(gen, *nodesp);
         }
-        INode *elemtype = nodesGet(((ArrayNode *) iTypeGetTypeDcl(lit->vtype))->elems, 0);
         return LLVMConstArray(genlType(gen, elemtype), values, size);
     }
     case TypeLitTag:
@@ -898,8 +1185,11 @@ LLVMValueRef genlExpr(GenState *gen, INode *termnode) {
     case VarNameUseTag:
     {
         VarDclNode *vardcl = (VarDclNode*)((NameUseNode *)termnode)->dclnode;
-        if (vardcl->tag == VarDclTag)
-            return LLVMBuildLoad(gen->builder, vardcl->llvmvar, &vardcl->namesym->namestr);
+        if (vardcl->tag == VarDclTag) {
+            LLVMValueRef val = LLVMBuildLoad(gen->builder, vardcl->llvmvar, &vardcl->namesym->namestr);
+            genlTbaa(gen, val, vardcl->vtype);
+            return val;
+        }
         else if (vardcl->tag == ConstDclTag) {
             ConstDclNode *constdcl = (ConstDclNode*)vardcl;
             return genlExpr(gen, constdcl->value);
@@ -915,7 +1205,7 @@ LLVMValueRef genlExpr(GenState *gen, INode *termnode) {
         if (reftype->tag == RefTag) {
             if (isRegion(reftype->region, soName))
                 genlDealiasOwn(gen, val, reftype);
-            else
+            else if (anode->aliasamt != 0)  // rc elision may have cancelled this alias
                 genlRcCounter(gen, val, anode->aliasamt, reftype);
         }
         else if (reftype->tag == TTupleTag) {
@@ -943,8 +1233,11 @@ LLVMValueRef genlExpr(GenState *gen, INode *termnode) {
     case ArrIndexTag:
     {
         // If no borrowing is involved, just get address of lval, then load value
-        if (!(termnode->flags & FlagBorrow))
-            return LLVMBuildLoad(gen->builder, genlAddr(gen, termnode), "");
+        if (!(termnode->flags & FlagBorrow)) {
+            LLVMValueRef val = LLVMBuildLoad(gen->builder, genlAddr(gen, termnode), "");
+            genlTbaa(gen, val, ((IExpNode*)termnode)->vtype);
+            return val;
+        }
 
         // If borrowing, alter fncall to shortcut around the borrow node
         FnCallNode *fncall = (FnCallNode *)termnode;
@@ -959,11 +1252,22 @@ LLVMValueRef genlExpr(GenState *gen, INode *termnode) {
         INode *objtyp = iexpGetTypeDcl(fncall->objfn);
         if (objtyp->tag == VirtRefTag) {
             LLVMValueRef fldpRef = genlAddr(gen, termnode);
-            return (termnode->flags & FlagBorrow)? fldpRef : LLVMBuildLoad(gen->builder, fldpRef, "");
+            if (termnode->flags & FlagBorrow)
+                return fldpRef;
+            LLVMValueRef val = LLVMBuildLoad(gen->builder, fldpRef, "");
+            genlTbaa(gen, val, flddcl->vtype);
+            return val;
         }
         else if (termnode->flags & FlagBorrow) {
             return LLVMBuildStructGEP(gen->builder, genlAddr(gen, fncall->objfn), flddcl->index, &flddcl->namesym->namestr);
         }
+        else if (genlIsMemLval(fncall->objfn)) {
+            // Load just the field, rather than the whole struct, when it lives in memory
+            LLVMValueRef fldp = LLVMBuildStructGEP(gen->builder, genlAddr(gen, fncall->objfn), flddcl->index, &flddcl->namesym->namestr);
+            LLVMValueRef val = LLVMBuildLoad(gen->builder, fldp, "");
+            genlTbaaField(gen, val, objtyp, flddcl);
+            return val;
+        }
         else {
             return LLVMBuildExtractValue(gen->builder, genlExpr(gen, fncall->objfn), flddcl->index, &flddcl->namesym->namestr);
         }
@@ -977,8 +1281,10 @@ LLVMValueRef genlExpr(GenState *gen, INode *termnode) {
         LLVMValueRef rvalptr = genlAddr(gen, rval);
         LLVMValueRef rightval = LLVMBuildLoad(gen->builder, rvalptr, "");
         LLVMValueRef leftval = LLVMBuildLoad(gen->builder, lvalptr, "");
-        LLVMBuildStore(gen->builder, rightval, lvalptr);
-        LLVMBuildStore(gen->builder, leftval, rvalptr);
+        genlTbaaLval(gen, rightval, rval);
+        genlTbaaLval(gen, leftval, lval);
+        genlTbaaLval(gen, LLVMBuildStore(gen->builder, rightval, lvalptr), lval);
+        genlTbaaLval(gen, LLVMBuildStore(gen->builder, leftval, rvalptr), rval);
         return leftval;
     }
     case AssignTag:
@@ -991,7 +1297,8 @@ LLVMValueRef genlExpr(GenState *gen, INode *termnode) {
             // Normal assignment, except value of expression is contents of lval before mutation
             LLVMValueRef lvalptr = genlAddr(gen, lval);
             LLVMValueRef leftval = LLVMBuildLoad(gen->builder, lvalptr, "");
-            LLVMBuildStore(gen->builder, valueref, lvalptr);
+            genlTbaaLval(gen, leftval, lval);
+            genlTbaaLval(gen, LLVMBuildStore(gen->builder, valueref, lvalptr), lval);
             return leftval;
         }
 
@@ -1075,7 +1382,11 @@ LLVMValueRef genlExpr(GenState *gen, INode *termnode) {
     case ArrayAllocTag:
         return genlallocref(gen, (RefNode*)termnode);
     case DerefTag:
-        return LLVMBuildLoad(gen->builder, genlExpr(gen, ((StarNode*)termnode)->vtexp), "deref");
+    {
+        LLVMValueRef val = LLVMBuildLoad(gen->builder, genlExpr(gen, ((StarNode*)termnode)->vtexp), "deref");
+        genlTbaa(gen, val, ((IExpNode*)termnode)->vtype);
+        return val;
+    }
     case OrLogicTag: case AndLogicTag:
         return genlLogic(gen, (LogicNode*)termnode);
     case NotLogicTag:
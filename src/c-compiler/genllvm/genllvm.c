@@ -153,6 +153,45 @@ char *genlMangleMethName(char *workbuf, FnDclNode *node) {
     return workbuf;
 }
 
+// Add a named enum attribute to a function's parameter (index 1+), return value (0) or function (~0)
+void genlFnAttr(GenState *gen, LLVMValueRef fn, LLVMAttributeIndex idx, char *name, uint64_t val) {
+    unsigned kind = LLVMGetEnumAttributeKindForName(name, strlen(name));
+    LLVMAddAttributeAtIndex(fn, idx, LLVMCreateEnumAttribute(gen->context, kind, val));
+}
+
+// Tell LLVM what a safe reference's permission and region guarantee about its pointer
+void genlRefAttrs(GenState *gen, LLVMValueRef fn, LLVMAttributeIndex idx, INode *type, int isparm) {
+    RefNode *reftype = (RefNode *)iTypeGetTypeDcl(type);
+    if (reftype->tag != RefTag)
+        return;
+
+    // Safe references are never null
+    genlFnAttr(gen, fn, idx, "nonnull", 0);
+
+    // An owned (rc, so, ...) reference's callee may write the allocation's header
+    // (e.g., its reference count, just before the pointed-to value), or even free it.
+    // Only a borrowed reference's object is guaranteed to outlive the call untouched.
+    if (iTypeGetTypeDcl(reftype->region) != borrowRef)
+        return;
+    LLVMTypeRef valtype = genlType(gen, reftype->vtexp);
+    if (LLVMTypeIsSized(valtype)) {
+        unsigned long long size = LLVMABISizeOfType(gen->datalayout, valtype);
+        if (size > 0)
+            genlFnAttr(gen, fn, idx, "dereferenceable", size);
+    }
+    if (!isparm)
+        return;
+
+    // uni: no other reference can reach the object during the call.
+    // imm (and opaq): nothing can change the object while this reference lives
+    uint16_t flags = permGetFlags(reftype->perm);
+    if (!(flags & MayAlias) || (flags & (MayWrite | RaceSafe)) == RaceSafe)
+        genlFnAttr(gen, fn, idx, "noalias", 0);
+    // imm and ro: callee cannot write through this reference
+    if ((flags & (MayRead | MayWrite)) == MayRead)
+        genlFnAttr(gen, fn, idx, "readonly", 0);
+}
+
 // Generate LLVMValueRef for a global function
 void genlGloFnName(GenState *gen, FnDclNode *glofn) {
     // Do not generate inline functions
@@ -166,6 +205,15 @@ void genlGloFnName(GenState *gen, FnDclNode *glofn) {
         char *fnname = glofn->namesym? &glofn->namesym->namestr : "";
         glofn->llvmvar = LLVMAddFunction(gen->module, manglednm, genlType(gen, glofn->vtype));
 
+        // Derive parameter and return attributes from reference permissions
+        FnSigNode *fnsig = (FnSigNode *)glofn->vtype;
+        INode **nodesp;
+        uint32_t cnt;
+        LLVMAttributeIndex idx = 1;
+        for (nodesFor(fnsig->parms, cnt, nodesp))
+            genlRefAttrs(gen, glofn->llvmvar, idx++, ((VarDclNode *)*nodesp)->vtype, 1);
+        genlRefAttrs(gen, glofn->llvmvar, LLVMAttributeReturnIndex, fnsig->rettype, 0);
+
         // Specify appropriate storage class, visibility and call convention
         // extern functions (linkedited in separately):
         if (glofn->flags & FlagSystem) {
@@ -183,9 +231,10 @@ void genlGloFnName(GenState *gen, FnDclNode *glofn) {
         if (!gen->opt->release && glofn->value) {
             LLVMMetadataRef fntype = LLVMDIBuilderCreateSubroutineType(gen->dibuilder,
                 gen->difile, NULL, 0, 0);
+            uint32_t linenbr = glofn->lexer ? lexerLineOf(glofn->lexer, glofn->srcoff, NULL) : 0;
             LLVMMetadataRef sp = LLVMDIBuilderCreateFunction(gen->dibuilder, gen->difile,
                 fnname, strlen(fnname), manglednm, strlen(manglednm),
-                gen->difile, glofn->linenbr, fntype, 0, 1, glofn->linenbr, LLVMDIFlagPublic, 0);
+                gen->difile, linenbr, fntype, 0, 1, linenbr, LLVMDIFlagPublic, 0);
             LLVMSetSubprogram(glofn->llvmvar, sp);
         }
     }
@@ -278,6 +327,18 @@ void genlPackage(GenState *gen, ProgramNode *pgm) {
 
     assert(pgm->tag == ProgramTag);
     gen->module = LLVMModuleCreateWithNameInContext(gen->opt->srcname, gen->context);
+    gen->freefn = NULL;
+    gen->arenanext = gen->arenaend = NULL;
+    gen->rcopcount = NULL;
+    memset(gen->poolallocfn, 0, sizeof(gen->poolallocfn));
+    memset(gen->poolfreefn, 0, sizeof(gen->poolfreefn));
+    // Type-based alias metadata only helps the optimizer, so only release builds get it
+    gen->tbaakind = LLVMGetMDKindIDInContext(gen->context, "tbaa", 4);
+    gen->tbaaroot = NULL;
+    if (gen->opt->release && !gen->opt->no_strict_aliasing) {
+        LLVMMetadataRef rootname = LLVMMDStringInContext2(gen->context, "Cone TBAA", 9);
+        gen->tbaaroot = LLVMMDNodeInContext2(gen->context, &rootname, 1);
+    }
     if (!gen->opt->release) {
         gen->dibuilder = LLVMCreateDIBuilder(gen->module);
         gen->difile = LLVMDIBuilderCreateFile(gen->dibuilder, "main.cone", 9, ".", 1);
@@ -313,6 +374,161 @@ void genlPackage(GenState *gen, ProgramNode *pgm) {
         LLVMDIBuilderFinalize(gen->dibuilder);
 }
 
+#ifdef CONE_TARGETS
+// Define the initializer for an LLVM backend that conec may be built with.
+// CMakeLists.txt defines CONE_TARGETS, and CONE_TARGET_<name> for each backend it links in.
+#define GenlTargetInit(name) \
+    void genlInit##name() { \
+        LLVMInitialize##name##TargetInfo(); \
+        LLVMInitialize##name##Target(); \
+        LLVMInitialize##name##TargetMC(); \
+        LLVMInitialize##name##AsmPrinter(); \
+    }
+
+#ifdef CONE_TARGET_AArch64
+GenlTargetInit(AArch64)
+#endif
+#ifdef CONE_TARGET_AMDGPU
+GenlTargetInit(AMDGPU)
+#endif
+#ifdef CONE_TARGET_ARM
+GenlTargetInit(ARM)
+#endif
+#ifdef CONE_TARGET_AVR
+GenlTargetInit(AVR)
+#endif
+#ifdef CONE_TARGET_BPF
+GenlTargetInit(BPF)
+#endif
+#ifdef CONE_TARGET_Hexagon
+GenlTargetInit(Hexagon)
+#endif
+#ifdef CONE_TARGET_Lanai
+GenlTargetInit(Lanai)
+#endif
+#ifdef CONE_TARGET_Mips
+GenlTargetInit(Mips)
+#endif
+#ifdef CONE_TARGET_MSP430
+GenlTargetInit(MSP430)
+#endif
+#ifdef CONE_TARGET_NVPTX
+GenlTargetInit(NVPTX)
+#endif
+#ifdef CONE_TARGET_PowerPC
+GenlTargetInit(PowerPC)
+#endif
+#ifdef CONE_TARGET_RISCV
+GenlTargetInit(RISCV)
+#endif
+#ifdef CONE_TARGET_Sparc
+GenlTargetInit(Sparc)
+#endif
+#ifdef CONE_TARGET_SystemZ
+GenlTargetInit(SystemZ)
+#endif
+#ifdef CONE_TARGET_WebAssembly
+GenlTargetInit(WebAssembly)
+#endif
+#ifdef CONE_TARGET_X86
+GenlTargetInit(X86)
+#endif
+#ifdef CONE_TARGET_XCore
+GenlTargetInit(XCore)
+#endif
+
+// Which backend handles a triple's architecture (matched by prefix)
+typedef struct {
+    char *arch;
+    void (*init)();
+} GenlTarget;
+
+GenlTarget genlTargets[] = {
+#ifdef CONE_TARGET_AArch64
+    {"aarch64", genlInitAArch64}, {"arm64", genlInitAArch64},
+#endif
+#ifdef CONE_TARGET_AMDGPU
+    {"amdgcn", genlInitAMDGPU}, {"r600", genlInitAMDGPU},
+#endif
+#ifdef CONE_TARGET_ARM
+    {"arm", genlInitARM}, {"thumb", genlInitARM},
+#endif
+#ifdef CONE_TARGET_AVR
+    {"avr", genlInitAVR},
+#endif
+#ifdef CONE_TARGET_BPF
+    {"bpf", genlInitBPF},
+#endif
+#ifdef CONE_TARGET_Hexagon
+    {"hexagon", genlInitHexagon},
+#endif
+#ifdef CONE_TARGET_Lanai
+    {"lanai", genlInitLanai},
+#endif
+#ifdef CONE_TARGET_Mips
+    {"mips", genlInitMips},
+#endif
+#ifdef CONE_TARGET_MSP430
+    {"msp430", genlInitMSP430},
+#endif
+#ifdef CONE_TARGET_NVPTX
+    {"nvptx", genlInitNVPTX},
+#endif
+#ifdef CONE_TARGET_PowerPC
+    {"powerpc", genlInitPowerPC}, {"ppc", genlInitPowerPC},
+#endif
+#ifdef CONE_TARGET_RISCV
+    {"riscv", genlInitRISCV},
+#endif
+#ifdef CONE_TARGET_Sparc
+    {"sparc", genlInitSparc},
+#endif
+#ifdef CONE_TARGET_SystemZ
+    {"s390x", genlInitSystemZ}, {"systemz", genlInitSystemZ},
+#endif
+#ifdef CONE_TARGET_WebAssembly
+    {"wasm", genlInitWebAssembly},
+#endif
+#ifdef CONE_TARGET_X86
+    {"x86", genlInitX86}, {"i386", genlInitX86}, {"i486", genlInitX86},
+    {"i586", genlInitX86}, {"i686", genlInitX86},
+#endif
+#ifdef CONE_TARGET_XCore
+    {"xcore", genlInitXCore},
+#endif
+    {NULL, NULL}
+};
+#endif
+
+// Initialize only the LLVM backend needed for the triple
+void genlInitTarget(char *triple) {
+    // The native backend is always linked in
+    char *hosttriple = LLVMGetDefaultTargetTriple();
+    int isnative = strcmp(triple, hosttriple) == 0;
+    LLVMDisposeMessage(hosttriple);
+    if (isnative) {
+        LLVMInitializeNativeTarget();
+        LLVMInitializeNativeAsmPrinter();
+        return;
+    }
+
+#ifdef CONE_TARGETS
+    for (GenlTarget *target = genlTargets; target->arch; ++target) {
+        if (strncmp(triple, target->arch, strlen(target->arch)) == 0) {
+            target->init();
+            return;
+        }
+    }
+    // No backend for it: LLVMGetTargetFromTriple will report the error
+#else
+    // Without a list of the backends we were built with, every one must be linked in
+    LLVMInitializeAllTargetInfos();
+    LLVMInitializeAllTargetMCs();
+    LLVMInitializeAllTargets();
+    LLVMInitializeAllAsmPrinters();
+#endif
+}
+
 // Use provided options (triple, etc.) to creation a machine
 LLVMTargetMachineRef genlCreateMachine(ConeOptions *opt) {
     char *err;
@@ -321,15 +537,10 @@ LLVMTargetMachineRef genlCreateMachine(ConeOptions *opt) {
     LLVMRelocMode reloc;
     LLVMTargetMachineRef machine;
 
-    LLVMInitializeAllTargetInfos();
-    LLVMInitializeAllTargetMCs();
-    LLVMInitializeAllTargets();
-    LLVMInitializeAllAsmPrinters();
-    LLVMInitializeAllAsmParsers();
-
     // Find target for the specified triple
     if (!opt->triple)
         opt->triple = LLVMGetDefaultTargetTriple();
+    genlInitTarget(opt->triple);
     if (LLVMGetTargetFromTriple(opt->triple, &target, &err) != 0) {
         errorMsg(ErrorGenErr, "Could not create target: %s", err);
         LLVMDisposeMessage(err);
@@ -401,13 +612,29 @@ void genpgm(GenState *gen, ProgramNode *pgm) {
         LLVMDisposeMessage(err);
     }
 
+    if (gen->opt->stop_after == StopAfterLlvm) {
+        LLVMDisposeModule(gen->module);
+        return;
+    }
+
     // Optimize the generated LLVM IR
     timerBegin(OptTimer);
     LLVMPassManagerRef passmgr = LLVMCreatePassManager();
+    if (gen->opt->release) {
+        LLVMAddTypeBasedAliasAnalysisPass(passmgr);  // Use TBAA metadata from genlTbaa()
+        LLVMAddScopedNoAliasAAPass(passmgr);         // Keep noalias facts about parameters of inlined functions
+    }
     LLVMAddPromoteMemoryToRegisterPass(passmgr);     // Demote allocas to registers.
+    if (gen->opt->release)
+        LLVMAddFunctionAttrsPass(passmgr);           // Infer readonly/readnone functions from their bodies
     //LLVMAddInstructionCombiningPass(passmgr);        // Do simple "peephole" and bit-twiddling optimizations
     LLVMAddReassociatePass(passmgr);                 // Reassociate expressions.
     LLVMAddGVNPass(passmgr);                         // Eliminate common subexpressions.
+    if (gen->opt->release) {
+        LLVMAddLoopRotatePass(passmgr);              // Put loop tests at the bottom, giving LICM a preheader
+        LLVMAddLICMPass(passmgr);                    // Hoist loads that noalias/readonly references prove invariant
+        LLVMAddLoopUnswitchPass(passmgr);            // Split loops on invariant conditions (hoisted bounds checks)
+    }
     LLVMAddCFGSimplificationPass(passmgr);           // Simplify the control flow graph
     if (gen->opt->release)
         LLVMAddFunctionInliningPass(passmgr);        // Function inlining
@@ -422,7 +649,7 @@ void genpgm(GenState *gen, ProgramNode *pgm) {
 
     // Transform IR to target's ASM and OBJ
     timerBegin(CodeGenTimer);
-    if (gen->machine)
+    if (gen->machine && gen->opt->stop_after != StopAfterOpt)
         genlOut(fileMakePath(gen->opt->output, gen->opt->srcname, gen->opt->wasm? "wasm" : objext),
             gen->opt->print_asm? fileMakePath(gen->opt->output, gen->opt->srcname, gen->opt->wasm? "wat" : asmext) : NULL,
             gen->module, gen->opt->triple, gen->machine);
@@ -431,7 +658,73 @@ void genpgm(GenState *gen, ProgramNode *pgm) {
     // LLVMContextDispose(gen.context);  // Only need if we created a new context
 }
 
-// Setup LLVM generation, ensuring we know intended target
+// Pointer size (in bits) of architectures, as named at the start of a triple.
+// Sizes are as LLVM's data layouts give them. A name ending in '*' also matches
+// that name followed by a version (e.g., armv7a or thumbv7em). Anything else
+// (including ILP32 ABIs of 64-bit architectures) asks the target's data layout.
+typedef struct {
+    char *arch;
+    int ptrsize;
+} GenlArchPtr;
+
+GenlArchPtr genlArchPtrs[] = {
+    {"x86_64", 64}, {"amd64", 64}, {"x86_64h", 64},
+    {"aarch64", 64}, {"aarch64_be", 64}, {"arm64", 64},
+    {"riscv64", 64}, {"ppc64", 64}, {"ppc64le", 64}, {"powerpc64", 64}, {"powerpc64le", 64},
+    {"mips64", 64}, {"mips64el", 64}, {"s390x", 64}, {"systemz", 64},
+    {"sparcv9", 64}, {"sparc64", 64}, {"wasm64", 64}, {"nvptx64", 64},
+    {"amdgcn", 64}, {"bpf", 64}, {"bpfel", 64}, {"bpfeb", 64}, {"ve", 64},
+    {"i386", 32}, {"i486", 32}, {"i586", 32}, {"i686", 32},
+    {"arm", 32}, {"armeb", 32}, {"thumb", 32}, {"thumbeb", 32}, {"armv*", 32}, {"thumbv*", 32},
+    {"riscv32", 32}, {"ppc", 32}, {"powerpc", 32}, {"mips", 32}, {"mipsel", 32},
+    {"sparc", 32}, {"sparcel", 32}, {"wasm32", 32}, {"nvptx", 32}, {"r600", 32},
+    {"hexagon", 32}, {"lanai", 32}, {"xcore", 32}, {"m68k", 32},
+    {"avr", 16}, {"msp430", 16},
+    {NULL, 0}
+};
+
+// Look up the pointer size of a triple's architecture, or 0 if it is not known
+int genlArchPtrSize(char *triple) {
+    size_t archlen = strcspn(triple, "-");
+
+    // A 64-bit architecture with an ILP32 ABI (e.g., x86_64-linux-gnux32) has 32-bit pointers
+    char *env = triple + archlen;
+    if (strstr(env, "x32") || strstr(env, "n32") || strstr(env, "ilp32"))
+        return 0;
+
+    for (GenlArchPtr *arch = genlArchPtrs; arch->arch; ++arch) {
+        size_t len = strlen(arch->arch);
+        if (arch->arch[len - 1] == '*') {
+            if (archlen >= len && strncmp(triple, arch->arch, len - 1) == 0)
+                return arch->ptrsize;
+        }
+        else if (archlen == len && strncmp(triple, arch->arch, len) == 0)
+            return arch->ptrsize;
+    }
+    return 0;
+}
+
+// Determine the intended target's triple and pointer size.
+// This is all that parsing and analysis need to know about the target.
+// For known architectures, it avoids the cost of initializing LLVM's target
+// (see genSetup). Otherwise, the pointer size comes from the target's data layout.
+void genTargetInfo(ConeOptions *opt) {
+    if (!opt->triple)
+        opt->triple = LLVMGetDefaultTargetTriple();
+
+    opt->ptrsize = genlArchPtrSize(opt->triple);
+    if (opt->ptrsize == 0) {
+        LLVMTargetMachineRef machine = genlCreateMachine(opt);
+        if (!machine)
+            exit(ExitOpts);
+        LLVMTargetDataRef datalayout = LLVMCreateTargetDataLayout(machine);
+        opt->ptrsize = LLVMPointerSize(datalayout) << 3;
+        LLVMDisposeTargetData(datalayout);
+        LLVMDisposeTargetMachine(machine);
+    }
+}
+
+// Setup LLVM generation for the intended target
 void genSetup(GenState *gen, ConeOptions *opt) {
     gen->opt = opt;
 
@@ -439,10 +732,10 @@ void genSetup(GenState *gen, ConeOptions *opt) {
     if (!machine)
         exit(ExitOpts);
 
-    // Obtain data layout info, particularly pointer sizes
+    // Obtain data layout info. Its pointer size is what genTargetInfo found.
     gen->machine = machine;
     gen->datalayout = LLVMCreateTargetDataLayout(machine);
-    opt->ptrsize = LLVMPointerSize(gen->datalayout) << 3;
+    assert((int)LLVMPointerSize(gen->datalayout) << 3 == opt->ptrsize);
 
     gen->context = LLVMGetGlobalContext(); // LLVM inlining bugs prevent use of LLVMContextCreate();
     gen->builder = LLVMCreateBuilder();
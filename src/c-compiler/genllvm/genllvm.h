@@ -17,10 +17,21 @@
 
 // An entry for each active loop block in current control flow stack
 #define GenBlockStackMax 256
+
+// Fixed-size so/rc allocations up to GenPoolMaxSize bytes use the runtime's
+// size-class pool (see conestd/pool.c), one class per GenPoolGranule bytes
+#define GenPoolGranule 16
+#define GenPoolMaxSize 256
+#define GenPoolClasses (GenPoolMaxSize / GenPoolGranule)
+
+// Aggregate values of at least this many bytes are stored using llvm.memset or
+// llvm.memcpy, rather than as a first-class value LLVM expands element by element
+#define GenMemcpyMin 64
 typedef struct {
     BlockNode *blocknode;
     LLVMBasicBlockRef blockbeg;
     LLVMBasicBlockRef blockend;
+    LLVMBasicBlockRef preheader;  // Loop: the block entering it, for loop-invariant code
     LLVMValueRef *phis;
     LLVMBasicBlockRef *blocksFrom;
     uint32_t phiCnt;
@@ -41,6 +52,14 @@ typedef struct GenState {
     LLVMMetadataRef difile;
 
     LLVMTypeRef emptyStructType;
+    LLVMMetadataRef tbaaroot;   // Root of the TBAA type tree (NULL when not emitting TBAA)
+    unsigned tbaakind;          // Metadata kind id for "tbaa"
+    LLVMValueRef freefn;        // Declaration of free() (declared on first use)
+    LLVMValueRef arenanext;     // Thread's next free byte in its arena chunk (declared on first use)
+    LLVMValueRef arenaend;      // End of thread's arena chunk
+    LLVMValueRef rcopcount;     // Runtime's count of executed rc/arc counter updates (--rc-count)
+    LLVMValueRef poolallocfn[GenPoolClasses];  // poolAlloc<size>() per size class (declared on first use)
+    LLVMValueRef poolfreefn[GenPoolClasses];   // poolFree<size>() per size class
 
     ConeOptions *opt;
     INode *fnblock;
@@ -54,7 +73,9 @@ enum FnCallDispatch {
     VirtDispatch     // Lookup function in vtable, and then dispatch
 };
 
-// Setup LLVM generation, ensuring we know intended target
+// Determine the intended target's triple and pointer size (without LLVM target setup)
+void genTargetInfo(ConeOptions *opt);
+// Setup LLVM generation for the intended target
 void genSetup(GenState *gen, ConeOptions *opt);
 void genClose(GenState *gen);
 void genpgm(GenState *gen, ProgramNode *pgm);
@@ -64,6 +85,7 @@ void genlGloFnName(GenState *gen, FnDclNode *glofn);
 
 // genlstmt.c
 LLVMBasicBlockRef genlInsertBlock(GenState *gen, char *name);
+GenBlockState *genFindBlockState(GenState *gen, BlockNode *block);
 LLVMValueRef genlBlock(GenState *gen, BlockNode *blk);
 
 // genlexpr.c
@@ -72,6 +94,11 @@ LLVMValueRef genlExpr(GenState *gen, INode *termnode);
 LLVMValueRef genlFnCallInternal(GenState *gen, int dispatch, INode *objfn, uint32_t fnargcnt, LLVMValueRef *fnargs);
 // Generate a panic
 void genlPanic(GenState *gen);
+// Return the byte every byte of a constant value is, or -1 if they differ (or it is not constant)
+int genlSplatByte(LLVMValueRef val);
+// Store a value to memory, using memset or memcpy for large aggregates
+// Returns the store instruction, or NULL if memset/memcpy was used
+LLVMValueRef genlStoreValue(GenState *gen, LLVMValueRef val, LLVMValueRef ptr);
 
 // genlalloc.c
 // Build usable metadata about a reference 
@@ -97,5 +124,9 @@ LLVMTypeRef genlUsize(GenState *gen);
 LLVMTypeRef genlEmptyStruct(GenState* gen);
 // Generate a vtable type
 void genlVtable(GenState *gen, Vtable *vtable);
+// Tag a load or store of a number or reference value with its TBAA type
+void genlTbaa(GenState *gen, LLVMValueRef inst, INode *type);
+// Tag a load or store of a struct's field with its TBAA struct path
+void genlTbaaField(GenState *gen, LLVMValueRef inst, INode *strtype, FieldDclNode *fld);
 
 #endif
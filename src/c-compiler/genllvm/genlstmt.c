@@ -79,11 +79,13 @@ LLVMValueRef genlBlock(GenState *gen, BlockNode *blk) {
 
     LLVMBasicBlockRef blockbeg = NULL;
     LLVMBasicBlockRef blockend = NULL;
+    LLVMBasicBlockRef preheader = NULL;
     GenBlockState *blkstate;
 
     if (isPhiBlk) {
         blockend = genlInsertBlock(gen, isLoop? "loopend" : "blockend");
         if (isLoop) {
+            preheader = LLVMGetInsertBlock(gen->builder);
             blockbeg = genlInsertBlock(gen, "loopbeg");
             LLVMBuildBr(gen->builder, blockbeg);
             LLVMPositionBuilderAtEnd(gen->builder, blockbeg);
@@ -98,6 +100,7 @@ LLVMValueRef genlBlock(GenState *gen, BlockNode *blk) {
         blkstate->blocknode = blk;
         blkstate->blockbeg = blockbeg;
         blkstate->blockend = blockend;
+        blkstate->preheader = preheader;
         if (blk->vtype->tag != VoidTag) {
             blkstate->phis = (LLVMValueRef*)memAllocBlk(sizeof(LLVMValueRef) * blk->breaks->used);
             blkstate->blocksFrom = (LLVMBasicBlockRef*)memAllocBlk(sizeof(LLVMBasicBlockRef) * blk->breaks->used);
@@ -443,3 +443,100 @@ LLVMValueRef genlSizeof(GenState *gen, INode *vtype) {
 LLVMTypeRef genlUsize(GenState *gen) {
     return (LLVMPointerSize(gen->datalayout) == 4) ? LLVMInt32TypeInContext(gen->context) : LLVMInt64TypeInContext(gen->context);
 }
+
+// Get a TBAA type node with the given name and parent
+LLVMMetadataRef genlTbaaNode(GenState *gen, char *name, LLVMMetadataRef parent) {
+    LLVMMetadataRef node[3];
+    node[0] = LLVMMDStringInContext2(gen->context, name, strlen(name));
+    node[1] = parent;
+    node[2] = LLVMValueAsMetadata(LLVMConstInt(LLVMInt64TypeInContext(gen->context), 0, 0));
+    return LLVMMDNodeInContext2(gen->context, node, 3);
+}
+
+// Get the TBAA type node for a number or reference type, or NULL for anything else.
+// All references and pointers share one node: their LLVM types are freely bitcast.
+// Like C's char, u8 is how raw bytes of any value are read and written (e.g., via *u8),
+// so every other type's node is a child of u8's, letting u8 accesses alias them all.
+LLVMMetadataRef genlTbaaScalar(GenState *gen, INode *type) {
+    INode *dcltype = iTypeGetTypeDcl(type);
+    LLVMMetadataRef bytenode = genlTbaaNode(gen, &u8Type->namesym->namestr, gen->tbaaroot);
+    if (dcltype == (INode*)u8Type)
+        return bytenode;
+    char *name;
+    switch (dcltype->tag) {
+    case IntNbrTag:
+    case UintNbrTag:
+    case FloatNbrTag:
+        name = &((NbrNode *)dcltype)->namesym->namestr;
+        break;
+    case RefTag:
+    case PtrTag:
+        name = "any pointer";
+        break;
+    default:
+        return NULL;
+    }
+    return genlTbaaNode(gen, name, bytenode);
+}
+
+// Get the TBAA type node for a struct, listing the offset of each field that has one.
+// Structs in a trait family are left out (NULL), as their variants overlay the same memory.
+// LLVM uniques metadata, so asking again yields the same node.
+LLVMMetadataRef genlTbaaStruct(GenState *gen, StructNode *strnode) {
+    if ((strnode->flags & (TraitType | OpaqueType)) || strnode->basetrait || strnode->genericinfo)
+        return NULL;
+    LLVMTypeRef structype = genlType(gen, (INode*)strnode);
+    char *name = &strnode->namesym->namestr;
+    LLVMMetadataRef *node = (LLVMMetadataRef *)memAllocBlk((1 + 2 * strnode->fields.used) * sizeof(LLVMMetadataRef));
+    uint32_t nodecnt = 0;
+    node[nodecnt++] = LLVMMDStringInContext2(gen->context, name, strlen(name));
+    INode **nodesp;
+    uint32_t cnt;
+    for (nodelistFor(&strnode->fields, cnt, nodesp)) {
+        FieldDclNode *fld = (FieldDclNode *)*nodesp;
+        INode *fldtype = iTypeGetTypeDcl(fld->vtype);
+        LLVMMetadataRef fldnode = fldtype->tag == StructTag ?
+            genlTbaaStruct(gen, (StructNode*)fldtype) : genlTbaaScalar(gen, fldtype);
+        if (fldnode == NULL)
+            continue;
+        unsigned long long offset = LLVMOffsetOfElement(gen->datalayout, structype, fld->index);
+        node[nodecnt++] = fldnode;
+        node[nodecnt++] = LLVMValueAsMetadata(LLVMConstInt(LLVMInt64TypeInContext(gen->context), offset, 0));
+    }
+    return nodecnt > 1 ? LLVMMDNodeInContext2(gen->context, node, nodecnt) : NULL;
+}
+
+// Attach a TBAA access tag (base type, access type, offset) to a load or store
+void genlTbaaTag(GenState *gen, LLVMValueRef inst, LLVMMetadataRef base, LLVMMetadataRef access, unsigned long long offset) {
+    LLVMMetadataRef tag[3];
+    tag[0] = base;
+    tag[1] = access;
+    tag[2] = LLVMValueAsMetadata(LLVMConstInt(LLVMInt64TypeInContext(gen->context), offset, 0));
+    LLVMSetMetadata(inst, gen->tbaakind, LLVMMetadataAsValue(gen->context, LLVMMDNodeInContext2(gen->context, tag, 3)));
+}
+
+// Tag a load or store of a number or reference value with its TBAA type.
+// Values of other types (e.g., aggregates) are left untagged, so may alias anything.
+void genlTbaa(GenState *gen, LLVMValueRef inst, INode *type) {
+    if (gen->tbaaroot == NULL)
+        return;
+    LLVMMetadataRef access = genlTbaaScalar(gen, type);
+    if (access)
+        genlTbaaTag(gen, inst, access, access, 0);
+}
+
+// Tag a load or store of a struct's field with its TBAA struct path,
+// or just the field's own type when the struct has no TBAA node
+void genlTbaaField(GenState *gen, LLVMValueRef inst, INode *strtype, FieldDclNode *fld) {
+    if (gen->tbaaroot == NULL)
+        return;
+    LLVMMetadataRef access = genlTbaaScalar(gen, fld->vtype);
+    if (access == NULL)
+        return;
+    StructNode *strnode = (StructNode *)iTypeGetTypeDcl(strtype);
+    LLVMMetadataRef base = strnode->tag == StructTag ? genlTbaaStruct(gen, strnode) : NULL;
+    if (base)
+        genlTbaaTag(gen, inst, base, access, LLVMOffsetOfElement(gen->datalayout, genlType(gen, (INode*)strnode), fld->index));
+    else
+        genlTbaaTag(gen, inst, access, access, 0);
+}
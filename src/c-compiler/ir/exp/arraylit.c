@@ -7,9 +7,76 @@
 
 #include "../ir.h"
 
+#include <string.h>
+
 // Note:  Creation, serialization and name checking are done with array type logic,
 // as we don't yet know whether [] is a type or an array literal
 
+// Can a literal of this kind and type be added to the array literal's packed elements?
+int arrayLitPackable(ArrayNode *arrlit, uint16_t littag, INode *littype) {
+    if (arrlit->packed)
+        return arrlit->packed->littag == littag && arrlit->packed->littype == littype;
+    // Only start packing when no elements have been parsed as nodes
+    return arrlit->elems->used == 0 && arrlit->dimens->used == 0;
+}
+
+// Add a numeric literal value (uint64_t or double bits) to an array literal's packed elements
+void arrayLitPackAdd(ArrayNode *arrlit, uint16_t littag, INode *littype, uint64_t bits, uint32_t srcoff) {
+    ArrayLitPack *pack = arrlit->packed;
+    if (pack == NULL) {
+        pack = arrlit->packed = memAllocBlk(sizeof(ArrayLitPack));
+        pack->littype = littype;
+        pack->littag = littag;
+        pack->used = 0;
+        pack->avail = 32;
+        pack->uintlits = memAllocBlk(pack->avail * sizeof(uint64_t));
+        pack->srcoffs = memAllocBlk(pack->avail * sizeof(uint32_t));
+    }
+    else if (pack->used >= pack->avail) {
+        uint64_t *uintlits = memAllocBlk(pack->avail * 2 * sizeof(uint64_t));
+        uint32_t *srcoffs = memAllocBlk(pack->avail * 2 * sizeof(uint32_t));
+        memcpy(uintlits, pack->uintlits, pack->used * sizeof(uint64_t));
+        memcpy(srcoffs, pack->srcoffs, pack->used * sizeof(uint32_t));
+        pack->uintlits = uintlits;
+        pack->srcoffs = srcoffs;
+        pack->avail *= 2;
+    }
+    // uint64_t and double are the same size, so floats are stored by their bits
+    memcpy(&pack->uintlits[pack->used], &bits, sizeof(uint64_t));
+    pack->srcoffs[pack->used++] = srcoff;
+}
+
+// Return the element type of an array literal's packed elements
+INode *arrayLitPackType(ArrayLitPack *pack) {
+    // Untyped integer literals default to i32 (see newULitNode)
+    if (pack->littype == unknownType)
+        return (INode*)i32Type;
+    return pack->littype;
+}
+
+// Replace an array literal's packed elements with literal nodes
+void arrayLitUnpack(ArrayNode *arrlit) {
+    ArrayLitPack *pack = arrlit->packed;
+    if (pack == NULL)
+        return;
+    for (uint32_t i = 0; i < pack->used; ++i) {
+        INode *lit;
+        if (pack->littag == ULitTag)
+            lit = (INode*)newULitNode(pack->uintlits[i], pack->littype);
+        else
+            lit = (INode*)newFLitNode(pack->floatlits[i], pack->littype);
+        lit->lexer = arrlit->lexer;
+        lit->srcoff = pack->srcoffs[i];
+        nodesAdd(&arrlit->elems, lit);
+    }
+    arrlit->packed = NULL;
+}
+
+// Return the number of elements listed in an array literal
+uint32_t arrayLitCount(ArrayNode *arrlit) {
+    return arrlit->packed ? arrlit->packed->used : arrlit->elems->used;
+}
+
 // Type check an array literal
 void arrayLitTypeCheckDimExp(TypeCheckState *pstate, ArrayNode *arrlit) {
 
@@ -54,6 +121,13 @@ void arrayLitTypeCheckDimExp(TypeCheckState *pstate, ArrayNode *arrlit) {
         return;
     }
 
+    // Packed literal values all share the same type
+    if (arrlit->packed) {
+        arrlit->vtype = (INode*)newArrayNodeTyped((INode*)arrlit, arrlit->packed->used,
+            arrayLitPackType(arrlit->packed));
+        return;
+    }
+
     // Otherwise handle multi-value array literal
     if (arrlit->elems->used == 0) {
         errorMsgNode((INode*)arrlit, ErrorBadArray, "Array literal list may not be empty");
@@ -8,6 +8,38 @@
 #ifndef arraylit_h
 #define arraylit_h
 
+// Array literals with at least this many plain numeric literals are kept packed
+#define ArrayLitPackMin 16
+
+// Packed elements of a homogeneous numeric array literal.
+// Rather than one literal node per element, values are kept in a single typed buffer.
+typedef struct ArrayLitPack {
+    INode *littype;      // The literals' lexed type (or unknownType)
+    union {
+        uint64_t *uintlits;  // Values, when littag is ULitTag
+        double *floatlits;   // Values, when littag is FLitTag
+    };
+    uint32_t *srcoffs;   // Source offset of each value
+    uint32_t used;       // Number of values
+    uint32_t avail;      // Allocated capacity
+    uint16_t littag;     // ULitTag or FLitTag
+} ArrayLitPack;
+
+// Add a numeric literal value (uint64_t or double bits) to an array literal's packed elements
+void arrayLitPackAdd(ArrayNode *arrlit, uint16_t littag, INode *littype, uint64_t bits, uint32_t srcoff);
+
+// Can a literal of this kind and type be added to the array literal's packed elements?
+int arrayLitPackable(ArrayNode *arrlit, uint16_t littag, INode *littype);
+
+// Return the element type of an array literal's packed elements
+INode *arrayLitPackType(ArrayLitPack *pack);
+
+// Replace an array literal's packed elements with literal nodes
+void arrayLitUnpack(ArrayNode *arrlit);
+
+// Return the number of elements listed in an array literal
+uint32_t arrayLitCount(ArrayNode *arrlit);
+
 // Type check an array literal (used by region allocation only)
 void arrayLitTypeCheckDimExp(TypeCheckState *pstate, ArrayNode *arrlit);
 
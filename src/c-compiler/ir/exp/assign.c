@@ -169,6 +169,7 @@ int assignlvalrtype(INode *lval, INode *rtype) {
         ((VarDclNode*)lvalvar)->flowtempflags |= VarInitialized;
         ((VarDclNode*)lvalvar)->flowtempflags &= 0xFFFF - VarMoved;
     }
+    flowUseLval(lval);
 
     // Handle lifetime enforcement for borrowed references
     RefNode* rvaltype = (RefNode *)rtype;
@@ -184,7 +185,7 @@ int assignlvalrtype(INode *lval, INode *rtype) {
 // Perform data flow analysis between two single assignment nodes:
 // - Lval is mutable
 // - Borrowed reference lifetime is greater than its container
-void assignSingleFlow(INode *lval, INode **rval) {
+void assignSingleFlow(FlowState *fstate, INode *lval, INode **rval) {
     // Handle lval-based data flow analysis
     if (assignlvalrtype(lval, ((IExpNode*)*rval)->vtype))
         return;
@@ -192,11 +193,11 @@ void assignSingleFlow(INode *lval, INode **rval) {
     // Non-anonymous lval means assignment moves/copies rvalue
     // - Enforce move semantics
     // - Handle copy semantic aliasing
-    flowHandleMoveOrCopy(rval);
+    flowHandleMoveOrCopy(fstate, rval);
 }
 
 // Handle parallel assignment (multiple values on both sides)
-void assignParaFlow(TupleNode *lval, TupleNode *rval) {
+void assignParaFlow(FlowState *fstate, TupleNode *lval, TupleNode *rval) {
     Nodes *lnodes = lval->elems;
     Nodes *rnodes = rval->elems;
     uint32_t lcnt;
@@ -204,7 +205,7 @@ void assignParaFlow(TupleNode *lval, TupleNode *rval) {
     INode **rnodesp = &nodesGet(rnodes, 0);
     uint32_t rcnt = rnodes->used;
     for (nodesFor(lnodes, lcnt, lnodesp)) {
-        assignSingleFlow(*lnodesp, rnodesp++);
+        assignSingleFlow(fstate, *lnodesp, rnodesp++);
         rcnt--;
     }
 }
@@ -224,11 +225,11 @@ void assignMultRetFlow(TupleNode *lval, INode **rval) {
 }
 
 // Handle when multiple expressions assigned to single lval
-void assignToOneFlow(INode *lval, TupleNode *rval) {
+void assignToOneFlow(FlowState *fstate, INode *lval, TupleNode *rval) {
     Nodes *rnodes = rval->elems;
     INode **rnodesp = &nodesGet(rnodes, 0);
     uint32_t rcnt = rnodes->used;
-    assignSingleFlow(lval, rnodesp++);
+    assignSingleFlow(fstate, lval, rnodesp++);
 }
 
 // Perform data flow analysis on assignment node
@@ -243,15 +244,15 @@ void assignFlow(FlowState *fstate, AssignNode **nodep) {
     INode *lval = node->lval;
     if (lval->tag == VTupleTag) {
         if (node->rval->tag == VTupleTag)
-            assignParaFlow((TupleNode*)node->lval, (TupleNode*)node->rval);
+            assignParaFlow(fstate, (TupleNode*)node->lval, (TupleNode*)node->rval);
         else
             assignMultRetFlow((TupleNode*)node->lval, &node->rval);
     }
     else {
         if (node->rval->tag == VTupleTag)
-            assignToOneFlow(node->lval, (TupleNode*)node->rval);
+            assignToOneFlow(fstate, node->lval, (TupleNode*)node->rval);
         else {
-            assignSingleFlow(node->lval, &node->rval);
+            assignSingleFlow(fstate, node->lval, &node->rval);
         }
     }
 }
@@ -78,12 +78,13 @@ void blockNameRes(NameResState *pstate, BlockNode *blk) {
     Name *lifesym = blk->lifesym;
     if (lifesym) {
         // If not already declared, hook lifetime symbol to block in global name table
-        if (!lifesym->node) {
+        INode *dupnode = nametblGetNode(lifesym);
+        if (!dupnode) {
             nametblHookNode(lifesym, (INode*)blk);
         }
         else {
                 errorMsgNode((INode *)blk, ErrorDupName, "Lifetime is already defined. Only one allowed.");
-                errorMsgNode((INode*)lifesym->node, ErrorDupName, "This is the conflicting definition for that name.");
+                errorMsgNode(dupnode, ErrorDupName, "This is the conflicting definition for that name.");
         }
     }
 
@@ -233,14 +234,14 @@ void blockNoBreak(BlockNode *blk) {
 // Perform data flow analysis on a block
 void blockFlow(FlowState *fstate, BlockNode **blknode) {
     BlockNode *blk = *blknode;
-    size_t svpos = flowScopePush();
+    size_t svpos = flowScopePush(fstate);
 
     // If this is function's main block, include parameters in flow analysis
     if (++fstate->scope == 2) {
         INode **nodesp;
         uint32_t cnt;
         for (nodesFor(fstate->fnsig->parms, cnt, nodesp))
-            flowAddVar((VarDclNode*)*nodesp);
+            flowAddVar(fstate, (VarDclNode*)*nodesp);
     }
 
     // Ensure last node is return, blockret, break or continue
@@ -294,7 +295,7 @@ void blockFlow(FlowState *fstate, BlockNode **blknode) {
     case ReturnTag:
     {
         INode **retexp = &((BreakRetNode *)*nodesp)->exp;
-        int doalias = flowScopeDealias(0, &((BreakRetNode *)*nodesp)->dealias, *retexp);
+        int doalias = flowScopeDealias(fstate, 0, &((BreakRetNode *)*nodesp)->dealias, *retexp);
         if (*retexp != unknownType && doalias) {
             flowLoadValue(fstate, retexp);
         }
@@ -303,23 +304,26 @@ void blockFlow(FlowState *fstate, BlockNode **blknode) {
     case BlockRetTag:
     {
         INode **retexp = &((BreakRetNode *)*nodesp)->exp;
-        int doalias = flowScopeDealias(svpos, &((BreakRetNode *)*nodesp)->dealias, *retexp);
+        int doalias = flowScopeDealias(fstate, svpos, &((BreakRetNode *)*nodesp)->dealias, *retexp);
         if ((*retexp)->tag != NilLitTag && doalias)
             flowLoadValue(fstate, retexp);
         break;
     }
     case BreakTag: {
         INode **brkexp = &((BreakRetNode *)*nodesp)->exp;
-        int doalias = flowScopeDealias(svpos, &((BreakRetNode *)*nodesp)->dealias, *brkexp);
+        int doalias = flowScopeDealias(fstate, svpos, &((BreakRetNode *)*nodesp)->dealias, *brkexp);
         if ((*brkexp)->tag != NilLitTag && doalias)
             flowLoadValue(fstate, brkexp);
         break;
     }
     case ContinueTag:
-        flowScopeDealias(svpos, &((BreakRetNode *)*nodesp)->dealias, NULL);
+        flowScopeDealias(fstate, svpos, &((BreakRetNode *)*nodesp)->dealias, NULL);
         break;
     }
+    flowScopeElide(fstate, svpos, ((BreakRetNode *)*nodesp)->dealias);
+    if ((*nodesp)->tag != BlockRetTag)
+        flowScopeExit(fstate, svpos);
 
     --fstate->scope;
-    flowScopePop(svpos);
+    flowScopePop(fstate, svpos);
 }
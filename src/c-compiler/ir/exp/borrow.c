@@ -147,4 +147,5 @@ void borrowFlow(FlowState *fstate, RefNode **nodep) {
     RefNode *node = *nodep;
     RefNode *reftype = (RefNode *)node->vtype;
     // Borrowed reference:  Deactivate source variable if necessary
+    flowUseBorrowed(node->vtexp);
 }
@@ -275,6 +275,91 @@ Name *fnCallOpEqMethod(Name *opeqname) {
     return NULL;
 }
 
+// Operator calls on primitive numbers (e.g., `+`, `==`, `+=`) are extremely common,
+// and their intrinsic methods never change once the core library is set up.
+// This cache remembers the method resolved for a number type, operator name,
+// self's reference-ness and argument type, so repeated operator calls can skip
+// namespace lookup and signature matching.
+typedef struct {
+    INode *nbrtype;          // Receiver's number type declaration (NULL if slot is empty)
+    Name *methsym;           // Operator/method name
+    INode *selfregion;       // Region of self, if self is a reference to the number (or NULL)
+    INode *selfperm;         // Permission of self, if self is a reference to the number (or NULL)
+    INode *argtype;          // Number type declaration of the only argument (or NULL)
+    uint32_t shape;          // Traits of self & argument that influence matching
+    FnDclNode *method;       // Resolved method
+} FnCallOpCacheEntry;
+
+#define FnCallOpCacheSize 1024    // Number of cache slots (must be power of 2)
+static FnCallOpCacheEntry *gFnCallOpCache = NULL;
+
+// Fill in cache key for a method call on a number. Return 0 if call is not cacheable.
+int fnCallOpCacheKey(FnCallOpCacheEntry *key, FnCallNode *callnode, INode *objdereftype) {
+    if (objdereftype->tag != UintNbrTag && objdereftype->tag != IntNbrTag && objdereftype->tag != FloatNbrTag)
+        return 0;
+    key->nbrtype = objdereftype;
+    key->methsym = callnode->methfld->namesym;
+    key->shape = 0;
+
+    // Self is either the number or a reference to it
+    INode *self = callnode->objfn;
+    INode *selftype = iexpGetTypeDcl(self);
+    if (selftype == objdereftype)
+        key->selfregion = key->selfperm = NULL;
+    else if (selftype->tag == RefTag && iTypeGetTypeDcl(((RefNode *)selftype)->vtexp) == objdereftype) {
+        key->selfregion = iTypeGetTypeDcl(((RefNode *)selftype)->region);
+        key->selfperm = iTypeGetTypeDcl(((RefNode *)selftype)->perm);
+    }
+    else
+        return 0;
+    if (iexpIsLval(self))
+        key->shape |= 1;
+
+    // Operators take at most one argument, which must be a number
+    key->argtype = NULL;
+    if (callnode->args && callnode->args->used > 0) {
+        INode *arg = nodesGet(callnode->args, 0);
+        if (callnode->args->used > 1)
+            return 0;
+        key->argtype = iexpGetTypeDcl(arg);
+        if (key->argtype->tag != UintNbrTag && key->argtype->tag != IntNbrTag && key->argtype->tag != FloatNbrTag)
+            return 0;
+        if (arg->tag == ULitTag && (arg->flags & FlagUnkType))
+            key->shape |= 2;
+        if (iexpIsLval(arg))
+            key->shape |= 4;
+    }
+    return 1;
+}
+
+// Return the cache slot for a key
+FnCallOpCacheEntry *fnCallOpCacheSlot(FnCallOpCacheEntry *key) {
+    if (gFnCallOpCache == NULL) {
+        gFnCallOpCache = (FnCallOpCacheEntry *)memAllocBlk(FnCallOpCacheSize * sizeof(FnCallOpCacheEntry));
+        memset(gFnCallOpCache, 0, FnCallOpCacheSize * sizeof(FnCallOpCacheEntry));
+    }
+    size_t hash = ((size_t)key->nbrtype >> 4) ^ ((size_t)key->methsym >> 4) ^ ((size_t)key->selfperm >> 2)
+        ^ ((size_t)key->argtype >> 6) ^ key->shape;
+    return &gFnCallOpCache[hash & (FnCallOpCacheSize - 1)];
+}
+
+// Return method cached for this key, or NULL if not cached
+FnDclNode *fnCallOpCacheFind(FnCallOpCacheEntry *key) {
+    FnCallOpCacheEntry *slot = fnCallOpCacheSlot(key);
+    if (slot->nbrtype == key->nbrtype && slot->methsym == key->methsym
+        && slot->selfregion == key->selfregion && slot->selfperm == key->selfperm
+        && slot->argtype == key->argtype && slot->shape == key->shape)
+        return slot->method;
+    return NULL;
+}
+
+// Remember the method resolved for this key (replacing whatever was in its slot)
+void fnCallOpCacheAdd(FnCallOpCacheEntry *key, FnDclNode *method) {
+    FnCallOpCacheEntry *slot = fnCallOpCacheSlot(key);
+    *slot = *key;
+    slot->method = method;
+}
+
 // Find best field or method (across overloaded methods whose type matches argument types)
 // Then lower the node to a function call (objfn+args) or field access (objfn+methfld) accordingly
 int fnCallLowerMethod(FnCallNode *callnode) {
@@ -291,31 +376,40 @@ int fnCallLowerMethod(FnCallNode *callnode) {
         && !(obj->tag==VarNameUseTag && ((VarDclNode*)((NameUseNode*)obj)->dclnode)->namesym == selfName)) {
         errorMsgNode((INode*)callnode, ErrorNotPublic, "May not access the private method/field `%s`.", &methsym->namestr);
     }
-    IExpNode *foundnode = (IExpNode*)iNsTypeFindFnField((INsTypeNode*)objdereftype, methsym);
-    if (!foundnode
-        || !(foundnode->tag == FnDclTag || foundnode->tag == FieldDclTag)
-        || !(foundnode->flags & FlagMethFld)) {
-        errorMsgNode((INode*)callnode, ErrorNotPublic, "Method or field `%s` not found.", &methsym->namestr);
-        return 0;
-    }
 
-    // Handle when methfld refers to a field
-    if (foundnode->tag == FieldDclTag) {
-        if (callnode->args != NULL)
-            errorMsgNode((INode*)callnode, ErrorManyArgs, "May not provide arguments for a field access");
+    // Use the cached resolution of an operator on a number, if we have one
+    FnCallOpCacheEntry opkey;
+    int opcacheable = fnCallOpCacheKey(&opkey, callnode, objdereftype);
+    FnDclNode *bestmethod = opcacheable ? fnCallOpCacheFind(&opkey) : NULL;
+    if (bestmethod == NULL) {
+        IExpNode *foundnode = (IExpNode*)iNsTypeFindFnField((INsTypeNode*)objdereftype, methsym);
+        if (!foundnode
+            || !(foundnode->tag == FnDclTag || foundnode->tag == FieldDclTag)
+            || !(foundnode->flags & FlagMethFld)) {
+            errorMsgNode((INode*)callnode, ErrorNotPublic, "Method or field `%s` not found.", &methsym->namestr);
+            return 0;
+        }
 
-        derefInject(&callnode->objfn);  // automatically deref any reference/ptr, if needed
-        callnode->methfld->tag = MbrNameUseTag;
-        callnode->methfld->dclnode = (INode*)foundnode;
-        callnode->vtype = callnode->methfld->vtype = foundnode->vtype;
-        callnode->tag = FldAccessTag;
-        return 1;
-    }
+        // Handle when methfld refers to a field
+        if (foundnode->tag == FieldDclTag) {
+            if (callnode->args != NULL)
+                errorMsgNode((INode*)callnode, ErrorManyArgs, "May not provide arguments for a field access");
+
+            derefInject(&callnode->objfn);  // automatically deref any reference/ptr, if needed
+            callnode->methfld->tag = MbrNameUseTag;
+            callnode->methfld->dclnode = (INode*)foundnode;
+            callnode->vtype = callnode->methfld->vtype = foundnode->vtype;
+            callnode->tag = FldAccessTag;
+            return 1;
+        }
 
-    FnDclNode *bestmethod = iNsTypeFindBestMethod((FnDclNode *)foundnode, &callnode->objfn, callnode->args);
-    if (bestmethod == NULL) {
-        errorMsgNode((INode*)callnode, ErrorNotPublic, "No matching method '%s' found that matches the call's arguments.", &methsym->namestr);
-        return 0;
+        bestmethod = iNsTypeFindBestMethod((FnDclNode *)foundnode, &callnode->objfn, callnode->args);
+        if (bestmethod == NULL) {
+            errorMsgNode((INode*)callnode, ErrorNotPublic, "No matching method '%s' found that matches the call's arguments.", &methsym->namestr);
+            return 0;
+        }
+        if (opcacheable)
+            fnCallOpCacheAdd(&opkey, bestmethod);
     }
 
     // For a method call, make sure object is specified as first argument
@@ -690,8 +784,11 @@ void fnCallFlow(FlowState *fstate, FnCallNode **nodep) {
     INode **argsp;
     uint32_t cnt;
     for (nodesFor(node->args, cnt, argsp)) {
+        // An 'each' loop's own step (&mut elem) does not void its range variable's limit
+        if ((node->flags & FlagRangeStep) && argsp == &nodesGet(node->args, 0))
+            continue;
         flowLoadValue(fstate, argsp);
-        flowHandleMoveOrCopy(argsp);  // Argument values are moved or copied
+        flowHandleMoveOrCopy(fstate, argsp);  // Argument values are moved or copied
     }
 }
 
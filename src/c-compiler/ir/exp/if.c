@@ -208,10 +208,14 @@ void ifFlow(FlowState *fstate, IfNode **ifnodep) {
     IfNode *ifnode = *ifnodep;
     INode **nodesp;
     uint32_t cnt;
+    int16_t svcondexp = fstate->condexp;
     for (nodesFor(ifnode->condblk, cnt, nodesp)) {
         if (*nodesp != elseCond)
             flowLoadValue(fstate, nodesp);
+        // Only the first condition is sure to be evaluated
+        ++fstate->condexp;
         nodesp++; cnt--;
         blockFlow(fstate, (BlockNode**)nodesp);
     }
+    fstate->condexp = svcondexp;
 }
@@ -74,7 +74,11 @@ INode *cloneULitNode(CloneState *cstate, ULitNode *lit) {
 
 // Serialize an Unsigned literal
 void ulitPrint(ULitNode *lit) {
-    if (((NbrNode*)lit->vtype)->bits == 1)
+    // vtype is a name use until name resolution, and it may never be resolved (e.g., in generics)
+    INode *vtype = lit->vtype;
+    if (vtype->tag == TypeNameUseTag)
+        vtype = ((NameUseNode*)vtype)->dclnode;
+    if ((vtype->tag == UintNbrTag || vtype->tag == IntNbrTag) && ((NbrNode*)vtype)->bits == 1)
         inodeFprint(lit->uintlit == 1 ? "true" : "false");
     else {
         inodeFprint("%ld", lit->uintlit);
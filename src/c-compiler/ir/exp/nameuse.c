@@ -153,8 +153,8 @@ void nameUseNameRes(NameResState *pstate, NameUseNode **namep) {
         name->dclnode = namespaceFind(namespace, name->namesym);
     }
     else
-        // For non-qualified names (current module), should already be hooked in global name table
-        name->dclnode = name->namesym->node;
+        // For non-qualified names, find what is hooked in global name table or current module chain
+        name->dclnode = nametblGetNode(name->namesym);
 
     if (!name->dclnode) {
         errorMsgNode((INode*)name, ErrorUnkName, "The name %s does not refer to a declared name", &name->namesym->namestr);
@@ -214,6 +214,7 @@ void nameuseFlow(FlowState *fstate, NameUseNode **nodep) {
     VarDclNode *vardclnode = (VarDclNode *)((NameUseNode*)node)->dclnode;
     if (vardclnode->tag != VarDclTag)
         return;
+    vardclnode->flowtempflags &= 0xFFFF - VarLastAliased;
     if (!(vardclnode->flowtempflags & VarInitialized))
         errorMsgNode((INode*)node, ErrorMove, "This variable has not been initialized. There is no value to use.");
     else if (vardclnode->flowtempflags & VarMoved)
@@ -39,12 +39,80 @@ void flowHandleMove(INode *node) {
     }
 }
 
+// Find the variable an lval-like expression (e.g., a.b[2].c) is rooted in, if any
+VarDclNode *flowRootVar(INode *node) {
+    while (1) {
+        switch (node->tag) {
+        case VarNameUseTag: {
+            VarDclNode *vardclnode = (VarDclNode *)((NameUseNode*)node)->dclnode;
+            return vardclnode->tag == VarDclTag ? vardclnode : NULL;
+        }
+        case FldAccessTag:
+        case ArrIndexTag:
+            node = ((FnCallNode*)node)->objfn;
+            break;
+        case DerefTag:
+            node = ((StarNode*)node)->vtexp;
+            break;
+        default:
+            return NULL;
+        }
+    }
+}
+
+// Note a variable's use as (or within) an lval, which flowLoadValue does not see
+void flowUseLval(INode *lval) {
+    VarDclNode *vardclnode = flowRootVar(lval);
+    if (vardclnode == NULL)
+        return;
+    vardclnode->flowtempflags &= 0xFFFF - VarLastAliased;
+    // Storing a new value to the variable: its later copies are of another object,
+    // and an 'each' range variable may no longer be within its limit
+    if (lval->tag == VarNameUseTag) {
+        vardclnode->flowalias = NULL;
+        vardclnode->rangelimit = NULL;
+    }
+}
+
+// Note that a variable has been borrowed from, so its rc count may not be elided
+// (nor may an 'each' range variable be trusted to stay within its limit).
+// A mutable borrow may store a new value to the variable, so later copies
+// must not coalesce into the alias of a copy made before the borrow.
+void flowUseBorrowed(INode *node) {
+    VarDclNode *vardclnode = flowRootVar(node);
+    if (vardclnode) {
+        vardclnode->flowtempflags |= VarBorrowed;
+        vardclnode->flowalias = NULL;
+        vardclnode->rangelimit = NULL;
+    }
+}
+
+// Coalesce an unconditional rc copy of a variable at its own block's scope
+// into the alias node of its earlier copy, if any. Copying to A and B then
+// increments the count by 2 when copying to A (never freeing the object sooner).
+// Returns 1 if the copy was coalesced (and needs no alias node of its own).
+int flowCoalesceAlias(FlowState *fstate, INode *node, AliasNode **aliasnodep) {
+    if (node->tag != VarNameUseTag)
+        return 0;
+    VarDclNode *vardclnode = (VarDclNode *)((NameUseNode*)node)->dclnode;
+    if (!fstate->coalesce || vardclnode->tag != VarDclTag || vardclnode->flowscope != fstate->scope || fstate->condexp > 0
+        || (vardclnode->flowtempflags & VarBorrowed))
+        return 0;
+    vardclnode->flowtempflags |= VarLastAliased;
+    if (vardclnode->flowalias) {
+        ++((AliasNode*)vardclnode->flowalias)->aliasamt;
+        return 1;
+    }
+    vardclnode->flowalias = (INode*)*aliasnodep;
+    return 0;
+}
+
 // If needed, inject an alias node for rc/own references
-void flowInjectAliasNode(INode **nodep) {
+void flowInjectAliasNode(FlowState *fstate, INode **nodep) {
     INode *vtype = ((IExpNode*)*nodep)->vtype;
     // No need for injected node if we are not dealing with rc references
     RefNode *reftype = (RefNode *) iTypeGetTypeDcl(vtype);
-    if (reftype->tag != RefTag || !isRegion(reftype->region, rcName))
+    if (reftype->tag != RefTag || !isRcRegion(reftype->region))
         return;
 
     // Inject alias count node
@@ -54,19 +122,21 @@ void flowInjectAliasNode(INode **nodep) {
     aliasnode->vtype = vtype;
     aliasnode->aliasamt = 1;
     aliasnode->counts = NULL;
+    if (flowCoalesceAlias(fstate, *nodep, &aliasnode))
+        return;
     *nodep = (INode*)aliasnode;
 }
 
 // Handle when we know we are either copying or moving a value
 // (e.g., for assignment or function arguments).
-void flowHandleMoveOrCopy(INode **nodep) {
+void flowHandleMoveOrCopy(FlowState *fstate, INode **nodep) {
     uint16_t moveflag = iTypeGetTypeDcl(((IExpNode *) *nodep)->vtype)->flags & MoveType;
     if (iexpIsMove(*nodep)) {
         // Moving needs to deactivate source variable use
         flowHandleMove(*nodep);
     }
     else {
-        flowInjectAliasNode(nodep);
+        flowInjectAliasNode(fstate, nodep);
     }
 }
 
@@ -126,7 +196,9 @@ void flowLoadValue(FlowState *fstate, INode **nodep) {
     {
         LogicNode *lnode = (LogicNode*)*nodep;
         flowLoadValue(fstate, &lnode->lexp);
+        ++fstate->condexp;
         flowLoadValue(fstate, &lnode->rexp);
+        --fstate->condexp;
         break;
     }
 
@@ -153,55 +225,52 @@ void flowLoadValue(FlowState *fstate, INode **nodep) {
 // - Has it been moved and has it not been moved?
 // *********************
 
-// An entry for a local declared name, in which we preserve its flow flags
-typedef struct {
-    VarDclNode *node;    // The variable declaration node
-    int16_t flags;       // The preserved flow flags
-} VarFlowInfo;
-
-VarFlowInfo *gVarFlowStackp = NULL;
-size_t gVarFlowStackSz = 0;
-size_t gVarFlowStackPos = 0;
+// Initialize flow state for analyzing a function with this signature
+void flowInit(FlowState *fstate, FnSigNode *fnsig) {
+    fstate->fnsig = fnsig;
+    fstate->scope = 1;
+    fstate->varstack = NULL;
+    fstate->varstacksz = 0;
+    fstate->varstackpos = 0;
+    fstate->condexp = 0;
+    fstate->coalesce = 1;
+}
 
 // Add a just declared variable to the data flow stack
-void flowAddVar(VarDclNode *varnode) {
+void flowAddVar(FlowState *fstate, VarDclNode *varnode) {
     // Ensure we have room for another variable
-    if (gVarFlowStackPos >= gVarFlowStackSz) {
-        if (gVarFlowStackSz == 0) {
-            gVarFlowStackSz = 1024;
-            gVarFlowStackp = (VarFlowInfo*)memAllocBlk(gVarFlowStackSz * sizeof(VarFlowInfo));
-            memset(gVarFlowStackp, 0, gVarFlowStackSz * sizeof(VarFlowInfo));
-            gVarFlowStackPos = 0;
-        }
-        else {
-            // Double table size, copying over old data
-            VarFlowInfo *oldtable = gVarFlowStackp;
-            int oldsize = gVarFlowStackSz;
-            gVarFlowStackSz <<= 1;
-            gVarFlowStackp = (VarFlowInfo*)memAllocBlk(gVarFlowStackSz * sizeof(VarFlowInfo));
-            memset(gVarFlowStackp, 0, gVarFlowStackSz * sizeof(VarFlowInfo));
-            memcpy(gVarFlowStackp, oldtable, oldsize * sizeof(VarFlowInfo));
-        }
+    if (fstate->varstackpos >= fstate->varstacksz) {
+        // Double table size (or allocate it), copying over old data
+        VarFlowInfo *oldtable = fstate->varstack;
+        size_t oldsize = fstate->varstacksz;
+        fstate->varstacksz = oldsize == 0 ? 32 : oldsize << 1;
+        fstate->varstack = (VarFlowInfo*)memAllocBlk(fstate->varstacksz * sizeof(VarFlowInfo));
+        memset(fstate->varstack, 0, fstate->varstacksz * sizeof(VarFlowInfo));
+        if (oldsize)
+            memcpy(fstate->varstack, oldtable, oldsize * sizeof(VarFlowInfo));
     }
-    VarFlowInfo *stackp = &gVarFlowStackp[gVarFlowStackPos++];
+    VarFlowInfo *stackp = &fstate->varstack[fstate->varstackpos++];
     stackp->node = varnode;
     stackp->flags = 0;
+    varnode->flowscope = fstate->scope;
+    varnode->flowalias = NULL;
+    varnode->flowtempflags &= 0xFFFF - (VarLastAliased | VarBorrowed);
 }
 
 // Start a new scope
-size_t flowScopePush() {
-    return gVarFlowStackPos;
+size_t flowScopePush(FlowState *fstate) {
+    return fstate->varstackpos;
 }
 
 // Create de-alias list of all own/rc reference variables (except single retexp name)
 // As a simple optimization: returns 0 if retexp name was not de-aliased
-int flowScopeDealias(size_t startpos, Nodes **varlist, INode *retexp) {
+int flowScopeDealias(FlowState *fstate, size_t startpos, Nodes **varlist, INode *retexp) {
     int doalias = 1;
-    size_t pos = gVarFlowStackPos;
+    size_t pos = fstate->varstackpos;
     while (pos > startpos) {
-        VarFlowInfo *avar = &gVarFlowStackp[--pos];
+        VarFlowInfo *avar = &fstate->varstack[--pos];
         RefNode *reftype = (RefNode*)avar->node->vtype;
-        if (reftype->tag == RefTag && (isRegion(reftype->region, soName) || isRegion(reftype->region, rcName))) {
+        if (reftype->tag == RefTag && (isRegion(reftype->region, soName) || isRcRegion(reftype->region))) {
             if (retexp && (retexp->tag != VarNameUseTag || ((NameUseNode *)retexp)->namesym != avar->node->namesym)) {
                 if (*varlist == NULL)
                     *varlist = newNodes(4);
@@ -214,7 +283,50 @@ int flowScopeDealias(size_t startpos, Nodes **varlist, INode *retexp) {
     return doalias;
 }
 
+// Once a scope-ending node is analyzed, cancel its de-alias of this block's rc variables
+// against their last copy's alias, which then takes over the variable's count.
+// This is safe when nothing (not even a borrow) uses the variable after that copy,
+// and the copy was made unconditionally in this block (not in a nested block or loop).
+// Outer variables de-aliased by this node (e.g., on return) lose their coalescing alias,
+// as that alias's extra count would otherwise never be released along this path.
+void flowScopeElide(FlowState *fstate, size_t blockpos, Nodes *varlist) {
+    if (varlist == NULL)
+        return;
+    uint32_t keep = 0;
+    INode **nodesp;
+    uint32_t cnt;
+    for (nodesFor(varlist, cnt, nodesp)) {
+        VarDclNode *var = (VarDclNode *)*nodesp;
+        if (var->flowalias && isRcRegion(((RefNode*)var->vtype)->region)) {
+            int isown = 0;
+            size_t pos;
+            for (pos = blockpos; pos < fstate->varstackpos && !isown; ++pos)
+                isown = fstate->varstack[pos].node == var;
+            if (isown && (var->flowtempflags & (VarLastAliased | VarBorrowed)) == VarLastAliased) {
+                --((AliasNode*)var->flowalias)->aliasamt;
+                continue;
+            }
+            var->flowalias = NULL;
+            var->flowtempflags &= 0xFFFF - VarLastAliased;
+        }
+        nodesGet(varlist, keep++) = (INode*)var;
+    }
+    varlist->used = keep;
+}
+
+// Once a block's early exit (return, break or continue) is analyzed, variables
+// declared outside that block lose their coalescing alias. Copies after that block
+// are skipped along the exit's path, so they may not add to an alias made before it.
+void flowScopeExit(FlowState *fstate, size_t blockpos) {
+    size_t pos;
+    for (pos = 0; pos < blockpos; ++pos) {
+        VarDclNode *var = fstate->varstack[pos].node;
+        var->flowalias = NULL;
+        var->flowtempflags &= 0xFFFF - VarLastAliased;
+    }
+}
+
 // Back out of current scope
-void flowScopePop(size_t startpos) {
-    gVarFlowStackPos = startpos;
+void flowScopePop(FlowState *fstate, size_t startpos) {
+    fstate->varstackpos = startpos;
 }
@@ -22,12 +22,27 @@
 typedef struct VarDclNode VarDclNode;
 typedef struct FnSigNode FnSigNode;
 
+// An entry for a local declared name, in which we preserve its flow flags
+typedef struct {
+    VarDclNode *node;    // The variable declaration node
+    int16_t flags;       // The preserved flow flags
+} VarFlowInfo;
+
 // Context used across the data flow pass for a specific function/method
+// Each function's flow analysis owns all its state, independent of any other function's
 typedef struct FlowState {
     FnSigNode *fnsig;    // The type signature of the function we are within
+    VarFlowInfo *varstack;  // Stack of variables declared in active scopes
+    size_t varstacksz;      // Allocated size of varstack
+    size_t varstackpos;     // Number of variables on varstack
     int16_t scope;      // Current block scope (2 = main block)
+    int16_t condexp;    // >0 when within an expression that may not be evaluated (e.g., 'and' rhs)
+    int16_t coalesce;   // 0 keeps every rc count update: no coalescing or elision (--no-rc-elide)
 } FlowState;
 
+// Initialize flow state for analyzing a function with this signature
+void flowInit(FlowState *fstate, FnSigNode *fnsig);
+
 // Perform data flow analysis on a node whose value we intend to load
 // At minimum, we check that it is a valid, readable value
 // copyflag indicates whether value is to be copied or moved
@@ -35,16 +50,21 @@ typedef struct FlowState {
 void flowLoadValue(FlowState *fstate, INode **nodep);
 
 // Add a just declared variable to the data flow stack
-void flowAddVar(VarDclNode *varnode);
+void flowAddVar(FlowState *fstate, VarDclNode *varnode);
 
 // Start a new scope
-size_t flowScopePush();
+size_t flowScopePush(FlowState *fstate);
 
 // Create de-alias list of all own/rc reference variables, except var found in retexp 
 // As a simple optimization: returns 1 if retexp name was not de-aliased
-int flowScopeDealias(size_t pos, Nodes **varlist, INode *retexp);
+int flowScopeDealias(FlowState *fstate, size_t pos, Nodes **varlist, INode *retexp);
+// Once a scope-ending node is analyzed, cancel its de-alias of this block's rc variables
+// against their last copy's alias, which then takes over the variable's count
+void flowScopeElide(FlowState *fstate, size_t blockpos, Nodes *varlist);
+// Once a block's early exit is analyzed, stop coalescing copies of variables outside the block
+void flowScopeExit(FlowState *fstate, size_t blockpos);
 // Back out of current scope
-void flowScopePop(size_t pos);
+void flowScopePop(FlowState *fstate, size_t pos);
 
 // Alias Node structure
 typedef struct {
@@ -55,6 +75,11 @@ typedef struct {
 } AliasNode;
 
 // Handle when moving or copying a value to a new destination
-void flowHandleMoveOrCopy(INode **nodep);
+void flowHandleMoveOrCopy(FlowState *fstate, INode **nodep);
+
+// Note a variable's use as (or within) an lval, which flowLoadValue does not see
+void flowUseLval(INode *lval);
+// Note that a variable has been borrowed from, so its rc count may not be elided
+void flowUseBorrowed(INode *node);
 
 #endif
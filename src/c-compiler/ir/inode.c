@@ -19,38 +19,127 @@
 void inodeLexCopy(INode *new, INode *old) {
     new->instnode = old->instnode;
     new->lexer = old->lexer;
-    new->linenbr = old->linenbr;
-    new->linep = old->linep;
-    new->srcp = old->srcp;
+    new->srcoff = old->srcoff;
 }
 
 // State for inodePrint
 FILE *irfile;
 int irIndent=0;
 int irIsNL = 1;
+int irJson = 0;      // Escape output as a single-line JSON string
+int irJsonSep = 0;   // A line break is pending as a space in JSON output
+
+// Output to irfile is buffered, rather than written one fragment at a time
+#define IrBufSize 65536
+char irBuf[IrBufSize];
+size_t irBufPos = 0;
+char irScratch[IrBufSize];
+
+// Precomputed indentation: every fourth level is marked with '|'
+#define IrIndentMax 64
+char irIndentStr[IrIndentMax * 2 + 1];
+
+// Write out whatever has been buffered
+void inodePrintFlush() {
+    fwrite(irBuf, 1, irBufPos, irfile);
+    irBufPos = 0;
+}
+
+// Append bytes to the output buffer
+void inodePrintWrite(char *str, size_t len) {
+    if (irBufPos + len > IrBufSize) {
+        inodePrintFlush();
+        if (len > IrBufSize) {
+            fwrite(str, 1, len, irfile);
+            return;
+        }
+    }
+    memcpy(irBuf + irBufPos, str, len);
+    irBufPos += len;
+}
+
+// Append bytes to the output buffer, escaped for use within a JSON string.
+// Newlines become spaces, so that each JSON record stays on one line.
+void inodePrintWriteJson(char *str, size_t len) {
+    char esc[8];
+    char *end = str + len;
+    if (irJsonSep && len > 0) {
+        inodePrintWrite(" ", 1);
+        irJsonSep = 0;
+    }
+    while (str < end) {
+        // Copy over the run of characters that need no escaping
+        char *run = str;
+        while (str < end && (unsigned char)*str >= ' ' && *str != '"' && *str != '\\')
+            ++str;
+        if (str > run)
+            inodePrintWrite(run, str - run);
+        if (str >= end)
+            break;
+        if (*str == '\n' || *str == '\r' || *str == '\t')
+            inodePrintWrite(" ", 1);
+        else if (*str == '"' || *str == '\\') {
+            esc[0] = '\\'; esc[1] = *str;
+            inodePrintWrite(esc, 2);
+        }
+        else
+            inodePrintWrite(esc, sprintf(esc, "\\u%04x", (unsigned char)*str));
+        ++str;
+    }
+}
 
 // Output a string to irfile
 void inodeFprint(char *str, ...) {
     va_list argptr;
+    irIsNL = 0;
+
+    // Format directly into the output buffer, or into scratch space if it must be escaped
+    char *text = irJson ? irScratch : irBuf + irBufPos;
+    size_t avail = irJson ? IrBufSize : IrBufSize - irBufPos;
     va_start(argptr, str);
-    vfprintf(irfile, str, argptr);
+    int len = vsnprintf(text, avail, str, argptr);
     va_end(argptr);
-    irIsNL = 0;
+    if (len < 0)
+        return;
+    if ((size_t)len >= avail) {
+        // Too long: format again into a block big enough to hold it
+        text = memAllocBlk(len + 1);
+        va_start(argptr, str);
+        vsnprintf(text, len + 1, str, argptr);
+        va_end(argptr);
+    }
+    else if (!irJson) {
+        irBufPos += len;
+        return;
+    }
+    if (irJson)
+        inodePrintWriteJson(text, len);
+    else
+        inodePrintWrite(text, len);
 }
 
 // Print new line character
 void inodePrintNL() {
-    if (!irIsNL)
-        fputc('\n', irfile);
+    if (!irIsNL) {
+        if (irJson)
+            irJsonSep = 1;
+        else
+            inodePrintWrite("\n", 1);
+    }
     irIsNL = 1;
 }
 
 // Output a line's beginning indentation
 void inodePrintIndent() {
-    int cnt;
-    for (cnt = 0; cnt<irIndent; cnt++)
-        fprintf(irfile, (cnt & 3) == 0 ? "| " : "  ");
     irIsNL = 0;
+    if (irJson)
+        return;
+    int cnt = irIndent;
+    while (cnt > IrIndentMax) {
+        inodePrintWrite(irIndentStr, IrIndentMax * 2);
+        cnt -= IrIndentMax;
+    }
+    inodePrintWrite(irIndentStr, cnt * 2);
 }
 
 // Increment indentation
@@ -186,11 +275,146 @@ void inodePrintNode(INode *node) {
     }
 }
 
+// Return the name of a node's tag (e.g., "FnDcl" for FnDclTag)
+char *inodeTagName(uint16_t tag) {
+    switch (tag) {
+    case ProgramTag: return "Program";
+    case IntrinsicTag: return "Intrinsic";
+    case ReturnTag: return "Return";
+    case BlockRetTag: return "BlockRet";
+    case BreakTag: return "Break";
+    case ContinueTag: return "Continue";
+    case SwapTag: return "Swap";
+    case ImportTag: return "Import";
+    case NameUseTag: return "NameUse";
+    case TupleTag: return "Tuple";
+    case StarTag: return "Star";
+    case ModuleTag: return "Module";
+    case FnDclTag: return "FnDcl";
+    case VarDclTag: return "VarDcl";
+    case FieldDclTag: return "FieldDcl";
+    case ConstDclTag: return "ConstDcl";
+    case VarNameUseTag: return "VarNameUse";
+    case MbrNameUseTag: return "MbrNameUse";
+    case NilLitTag: return "NilLit";
+    case ULitTag: return "ULit";
+    case FLitTag: return "FLit";
+    case StringLitTag: return "StringLit";
+    case ArrayLitTag: return "ArrayLit";
+    case TypeLitTag: return "TypeLit";
+    case VTupleTag: return "VTuple";
+    case AssignTag: return "Assign";
+    case FnCallTag: return "FnCall";
+    case ArrIndexTag: return "ArrIndex";
+    case FldAccessTag: return "FldAccess";
+    case SizeofTag: return "Sizeof";
+    case CastTag: return "Cast";
+    case BorrowTag: return "Borrow";
+    case ArrayBorrowTag: return "ArrayBorrow";
+    case AllocateTag: return "Allocate";
+    case ArrayAllocTag: return "ArrayAlloc";
+    case DerefTag: return "Deref";
+    case NotLogicTag: return "NotLogic";
+    case OrLogicTag: return "OrLogic";
+    case AndLogicTag: return "AndLogic";
+    case IsTag: return "Is";
+    case BlockTag: return "Block";
+    case IfTag: return "If";
+    case AliasTag: return "Alias";
+    case NamedValTag: return "NamedVal";
+    case AbsenceTag: return "Absence";
+    case TypeNameUseTag: return "TypeNameUse";
+    case TypedefTag: return "Typedef";
+    case FnSigTag: return "FnSig";
+    case ArrayTag: return "Array";
+    case RefTag: return "Ref";
+    case ArrayRefTag: return "ArrayRef";
+    case VirtRefTag: return "VirtRef";
+    case ArrayDerefTag: return "ArrayDeref";
+    case PtrTag: return "Ptr";
+    case TTupleTag: return "TTuple";
+    case VoidTag: return "Void";
+    case QuesTag: return "Ques";
+    case BorrowRegTag: return "BorrowReg";
+    case UnknownTag: return "Unknown";
+    case EnumTag: return "Enum";
+    case LifetimeTag: return "Lifetime";
+    case IntNbrTag: return "IntNbr";
+    case UintNbrTag: return "UintNbr";
+    case FloatNbrTag: return "FloatNbr";
+    case StructTag: return "Struct";
+    case PermTag: return "Perm";
+    case MacroNameTag: return "MacroName";
+    case GenericNameTag: return "GenericName";
+    case GenVarUseTag: return "GenVarUse";
+    case MacroDclTag: return "MacroDcl";
+    case GenVarDclTag: return "GenVarDcl";
+    default: return "Unknown";
+    }
+}
+
+// Open irfile for buffered output
+void inodePrintOpen(char *dir, char *srcfn, char *ext) {
+    irfile = fopen(fileMakePath(dir, srcfn, ext), "wb");
+    irBufPos = 0;
+    irIndent = 0;
+    irIsNL = 1;
+    for (int cnt = 0; cnt < IrIndentMax; cnt++) {
+        irIndentStr[cnt * 2] = (cnt & 3) == 0 ? '|' : ' ';
+        irIndentStr[cnt * 2 + 1] = ' ';
+    }
+}
+
+// Flush and close irfile
+void inodePrintClose() {
+    inodePrintFlush();
+    fclose(irfile);
+}
+
 // Serialize the program's IR to dir+srcfn
 void inodePrint(char *dir, char *srcfn, INode *pgmnode) {
-    irfile = fopen(fileMakePath(dir, pgmnode->lexer->fname, "ast"), "wb");
+    inodePrintOpen(dir, srcfn, "ast");
     inodePrintNode(pgmnode);
-    fclose(irfile);
+    inodePrintClose();
+}
+
+// Serialize a module's nodes as JSON records, one line per node
+void inodePrintJsonMod(ModuleNode *mod) {
+    char *modname = mod->namesym ? &mod->namesym->namestr : "";
+    INode **nodesp;
+    uint32_t cnt;
+    for (nodesFor(mod->nodes, cnt, nodesp)) {
+        INode *node = *nodesp;
+        if (node->tag == ModuleTag) {
+            inodePrintJsonMod((ModuleNode*)node);
+            continue;
+        }
+        Name *name = isNamedNode(node) ? inodeGetName(node) : NULL;
+        char *namestr = name ? &name->namestr : "";
+        inodeFprint("{\"module\":\"");
+        inodePrintWriteJson(modname, strlen(modname));
+        inodeFprint("\",\"tag\":\"%s\",\"name\":\"", inodeTagName(node->tag));
+        inodePrintWriteJson(namestr, strlen(namestr));
+        inodeFprint("\",\"line\":%u,\"ir\":\"",
+            node->lexer ? lexerLineOf(node->lexer, node->srcoff, NULL) : 0);
+        irJson = 1;
+        irIsNL = 1;
+        inodePrintNode(node);
+        irJson = irJsonSep = 0;
+        inodeFprint("\"}\n");
+    }
+}
+
+// Serialize the program's IR to dir+srcfn as compact JSON lines:
+// one record per module-level node, holding its IR on a single line
+void inodePrintJson(char *dir, char *srcfn, INode *pgmnode) {
+    ProgramNode *pgm = (ProgramNode*)pgmnode;
+    inodePrintOpen(dir, srcfn, "irjson");
+    INode **nodesp;
+    uint32_t cnt;
+    for (nodesFor(pgm->modules, cnt, nodesp))
+        inodePrintJsonMod((ModuleNode*)*nodesp);
+    inodePrintClose();
 }
 
 // Dispatch a node walk for the current semantic analysis pass
@@ -455,6 +679,10 @@ Name *inodeGetName(INode *node) {
         return ((ConstDclNode*)node)->namesym;
     case GenVarDclTag:
         return ((GenVarDclNode *)node)->namesym;
+    case MacroDclTag:
+        return ((MacroDclNode *)node)->namesym;
+    case ModuleTag:
+        return ((ModuleNode *)node)->namesym;
     default:
         assert(0 && "Unknown node to get name from");
         return NULL;
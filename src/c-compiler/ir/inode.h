@@ -25,16 +25,13 @@
 // - tag contains the NodeTags code
 // - flags contains node-specific flags
 // - instnode points to what triggered instancing, if not NULL
-// - lexer contains -> url (filepath) and -> source
-// - srcp points to start of source token
-// - linep points to start of line that token begins on
-// - linenbr is the source file's line number, starting with 1
+// - lexer contains -> url (filepath), -> source and its line index
+// - srcoff is the offset of the source token's start in lexer's source
+//   (use lexerLineOf to obtain its line number and start of line)
 #define INodeHdr \
     INode *instnode; \
     Lexer *lexer; \
-    char *srcp; \
-    char *linep; \
-    uint32_t linenbr; \
+    uint32_t srcoff; \
     uint16_t tag; \
     uint16_t flags
 
@@ -181,6 +178,7 @@ enum NodeTags {
 #define FlagVDisp     0x0004        // FnCall: a virtual dispatch function call
 #define FlagLvalOp    0x0008        // FnCall: op requires an lval as object (a mutable ref)
 #define FlagOpAssgn   0x0010        // FnCall: method is an operator assignment (e.g., +=)
+#define FlagRangeStep 0x0020        // FnCall: an 'each' loop's step of its range variable
 
 #define FlagLoop      0x0001        // Block: is a Loop block
 
@@ -204,24 +202,22 @@ enum NodeTags {
 #define TypeChecked        0x8000  // Type has been type-checked
 #define TypeChecking       0x4000  // Type is in process of being type-checked
 
-// Allocate and initialize the INode portion of a new node
+// Allocate and initialize the INode portion of a new node.
+// It has no source position yet: the parser gives one to the nodes it creates (parsePos),
+// and nodes created by later passes copy it from the node they came from (copyNodeLex).
 #define newNode(node, nodestruct, nodetype) {\
     node = (nodestruct*) memAllocBlk(sizeof(nodestruct)); \
     node->tag = nodetype; \
     node->flags = 0; \
     node->instnode = NULL; \
-    node->lexer = lex; \
-    node->srcp = lex->tokp; \
-    node->linep = lex->linep; \
-    node->linenbr = lex->linenbr; \
+    node->lexer = NULL; \
+    node->srcoff = 0; \
 }
 
 // Copy lexer info over to another node
 #define copyNodeLex(newnode, oldnode) { \
     (newnode)->lexer = (oldnode)->lexer; \
-    (newnode)->srcp = (oldnode)->srcp; \
-    (newnode)->linep = (oldnode)->linep; \
-    (newnode)->linenbr = (oldnode)->linenbr; \
+    (newnode)->srcoff = (oldnode)->srcoff; \
 }
 
 // Copy lexer info over
@@ -229,6 +225,8 @@ void inodeLexCopy(INode *new, INode *old);
 
 // Helper functions for serializing a node
 void inodePrint(char *dir, char *srcfn, INode *pgm);
+void inodePrintJson(char *dir, char *srcfn, INode *pgm);
+char *inodeTagName(uint16_t tag);
 void inodePrintNode(INode *node);
 void inodeFprint(char *str, ...);
 void inodePrintNL();
@@ -10,6 +10,200 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdarg.h>
+#include <assert.h>
+
+// ************************ Overloaded method index *******************************
+
+// A type may overload a method name many times (e.g., a stream's `<-` for every
+// kind of value it can append). Rather than having every call site walk the whole
+// chain doing full signature matching, a long chain is lazily indexed by arity and
+// by the match key of the first argument after self. Only the methods in the
+// call's bucket can possibly be a perfect match, so those are tried first.
+// A resolution memo further remembers which method was chosen for a specific
+// list of argument types, so that repeated calls skip signature matching altogether.
+
+#define MethIndexMinChain 4    // Shorter method chains are just scanned
+
+// An indexed method, for one arity it accepts
+typedef struct MethIndexEntry {
+    FnDclNode *meth;                // The overloaded method
+    size_t key;                     // Match key of its first parameter after self
+    uint32_t arity;                 // Number of arguments (including self) it accepts
+    struct MethIndexEntry *next;    // Next entry in bucket (in chain order)
+} MethIndexEntry;
+
+// Index of all overloaded methods in a chain, hashed by arity and match key
+typedef struct MethIndex {
+    MethIndexEntry **buckets;
+    size_t avail;                   // Number of buckets (power of 2)
+} MethIndex;
+
+#define methIndexHash(key, arity, size) \
+    (assert(((size)&((size)-1))==0), (size_t) ((((key) >> 3) ^ ((key) >> 9) ^ (arity)) & ((size)-1)) )
+
+// Return the match key for a parameter or argument's type:
+// a type can only be an exact match for a type with the same match key.
+// Numbers match on kind and size, other nominal types on their declaration.
+// Structural types all share key 0, as equivalence requires a structural compare.
+size_t iNsTypeMatchKey(INode *type) {
+    INode *dcltype = iTypeGetTypeDcl(type);
+    switch (dcltype->tag) {
+    case UintNbrTag:
+    case IntNbrTag:
+    case FloatNbrTag:
+        return ((size_t)dcltype->tag << 8) | ((NbrNode*)dcltype)->bits;
+    case StructTag:
+        return (size_t)dcltype;
+    default:
+        return 0;
+    }
+}
+
+// Add a method to the index for one arity it accepts
+void iNsTypeIndexAdd(MethIndex *index, FnDclNode *meth, uint32_t arity) {
+    Nodes *parms = ((FnSigNode *)meth->vtype)->parms;
+    MethIndexEntry *entry = (MethIndexEntry *)memAllocBlk(sizeof(MethIndexEntry));
+    entry->meth = meth;
+    entry->arity = arity;
+    entry->key = arity > 1 ? iNsTypeMatchKey(((IExpNode *)nodesGet(parms, 1))->vtype) : 0;
+    entry->next = NULL;
+
+    // Append to end of bucket, so that bucket preserves chain order
+    MethIndexEntry **bucketp = &index->buckets[methIndexHash(entry->key, arity, index->avail)];
+    while (*bucketp)
+        bucketp = &(*bucketp)->next;
+    *bucketp = entry;
+}
+
+// Build index for a chain of overloaded methods, or return NULL if chain is too short to benefit
+MethIndex *iNsTypeIndexMethods(FnDclNode *firstmethod) {
+    uint32_t nmeths = 0;
+    for (FnDclNode *methnode = firstmethod; methnode; methnode = methnode->nextnode)
+        ++nmeths;
+    if (nmeths < MethIndexMinChain)
+        return NULL;
+
+    MethIndex *index = (MethIndex *)memAllocBlk(sizeof(MethIndex));
+    index->avail = 8;
+    while (index->avail < nmeths)
+        index->avail <<= 1;
+    index->buckets = (MethIndexEntry **)memAllocBlk(index->avail * sizeof(MethIndexEntry *));
+    memset(index->buckets, 0, index->avail * sizeof(MethIndexEntry *));
+
+    // A method accepts its full count of arguments, and any shorter count
+    // where the next parameter has a default value (see fnSigMatchMethCall)
+    for (FnDclNode *methnode = firstmethod; methnode; methnode = methnode->nextnode) {
+        Nodes *parms = ((FnSigNode *)methnode->vtype)->parms;
+        if (parms->used == 0)
+            continue;
+        for (uint32_t arity = 1; arity < parms->used; ++arity) {
+            if (((VarDclNode *)nodesGet(parms, arity))->value != NULL)
+                iNsTypeIndexAdd(index, methnode, arity);
+        }
+        iNsTypeIndexAdd(index, methnode, parms->used);
+    }
+    return index;
+}
+
+// Return the method chain's index (building it if needed), or NULL if it has none
+MethIndex *iNsTypeGetIndex(FnDclNode *firstmethod) {
+    if (firstmethod->overloads == NULL)
+        firstmethod->overloads = iNsTypeIndexMethods(firstmethod);
+    return firstmethod->overloads;
+}
+
+// ************************ Method resolution memo *******************************
+
+// A memo entry remembers the method resolved for a method chain and argument types
+typedef struct {
+    FnDclNode *firstmethod;   // The method chain searched (NULL if slot is empty)
+    INode **argtypes;         // Type declarations of self and then each argument
+    size_t hash;              // Computed hash of all the above
+    uint32_t argcnt;          // Number of types in argtypes
+    uint32_t shape;           // Two bits per argument: untyped literal? lval?
+    FnDclNode *bestmethod;    // The resolved method (NULL if none matches)
+} MethMemoEntry;
+
+#define MethMemoMaxArgs 16    // Calls with more args (including self) are not memoized
+
+// Memo table configuration variables
+size_t gMethMemoInitSize = 1024;     // Initial number of slots (must be power of 2)
+unsigned int gMethMemoUtil = 50;     // % utilization that triggers doubling of table
+
+// Private globals
+static MethMemoEntry *gMethMemo = NULL;    // The memo table array
+static size_t gMethMemoAvail = 0;          // Number of allocated slots (power of 2)
+static size_t gMethMemoCeil = 0;           // Ceiling that triggers table growth
+static size_t gMethMemoUsed = 0;           // Number of slots used
+
+/** Calculate index into memo table for a key using linear probing
+ * The table's slot at index is either empty or matches the provided key
+ */
+#define methMemoFindSlot(slotp, table, avail, hsh, first, types, cnt, shp) \
+{ \
+    size_t tbli; \
+    for (tbli = (hsh) & ((avail) - 1);;) { \
+        slotp = &(table)[tbli]; \
+        if (slotp->firstmethod == NULL || (slotp->hash == (hsh) && methMemoIsSame(slotp, first, types, cnt, shp))) \
+            break; \
+        tbli = (tbli + 1) & ((avail) - 1); \
+    } \
+}
+
+// Return 1 if the memo entry is for the specified method chain and argument types
+int methMemoIsSame(MethMemoEntry *entry, FnDclNode *firstmethod, INode **argtypes, uint32_t argcnt, uint32_t shape) {
+    if (entry->firstmethod != firstmethod || entry->argcnt != argcnt || entry->shape != shape)
+        return 0;
+    for (uint32_t i = 0; i < argcnt; ++i) {
+        if (!iTypeIsSame(entry->argtypes[i], argtypes[i]))
+            return 0;
+    }
+    return 1;
+}
+
+// Grow the memo table, by either creating it or doubling its size
+void iNsTypeMemoGrow() {
+    MethMemoEntry *oldTable = gMethMemo;
+    size_t oldTblAvail = gMethMemoAvail;
+
+    gMethMemoAvail = oldTblAvail == 0 ? gMethMemoInitSize : oldTblAvail << 1;
+    gMethMemoCeil = (gMethMemoUtil * gMethMemoAvail) / 100;
+    size_t newTblMem = gMethMemoAvail * sizeof(MethMemoEntry);
+    gMethMemo = (MethMemoEntry *)memAllocBlk(newTblMem);
+    memset(gMethMemo, 0, newTblMem);
+
+    // Copy existing entries to re-hashed positions in new table
+    for (size_t oldslot = 0; oldslot < oldTblAvail; oldslot++) {
+        MethMemoEntry *oldslotp = &oldTable[oldslot];
+        if (oldslotp->firstmethod) {
+            size_t tbli;
+            for (tbli = oldslotp->hash & (gMethMemoAvail - 1); gMethMemo[tbli].firstmethod; tbli = (tbli + 1) & (gMethMemoAvail - 1))
+                ;
+            gMethMemo[tbli] = *oldslotp;
+        }
+    }
+}
+
+// Forget all memoized method resolutions (e.g., when a method chain changes)
+void iNsTypeMemoReset() {
+    if (gMethMemoUsed == 0)
+        return;
+    memset(gMethMemo, 0, gMethMemoAvail * sizeof(MethMemoEntry));
+    gMethMemoUsed = 0;
+}
+
+// Find method using the chain's index: only a bucket's candidates can be a perfect match
+// Return NULL if no perfect match is found
+FnDclNode *iNsTypeFindIndexedMethod(MethIndex *index, INode **self, Nodes *args) {
+    uint32_t arity = args ? args->used + 1 : 1;
+    size_t key = arity > 1 ? iNsTypeMatchKey(((IExpNode *)nodesGet(args, 0))->vtype) : 0;
+    for (MethIndexEntry *entry = index->buckets[methIndexHash(key, arity, index->avail)]; entry; entry = entry->next) {
+        if (entry->key == key && entry->arity == arity
+            && fnSigMatchMethCall((FnSigNode *)entry->meth->vtype, self, args) == 1)
+            return entry->meth;
+    }
+    return NULL;
+}
 
 // Initialize common fields
 void iNsTypeInit(INsTypeNode *type, int nodecnt) {
@@ -28,6 +222,10 @@ void iNsTypeAddFnDict(INsTypeNode *type, FnDclNode *fnnode) {
             errorMsgNode((INode*)fnnode, ErrorDupName, "Duplicate name %s: Only methods can be overloaded.", &fnnode->namesym->namestr);
             return;
         }
+        // Any index or memoized resolution of this method chain is now stale.
+        // Short chains have no index, but may still have been memoized.
+        foundnode->overloads = NULL;
+        iNsTypeMemoReset();
         // Append to end of linked method list
         while (foundnode->nextnode)
             foundnode = foundnode->nextnode;
@@ -48,8 +246,8 @@ INode *iNsTypeFindFnField(INsTypeNode *type, Name *name) {
     return namespaceFind(&type->namespace, name);
 }
 
-// Find method that best fits the passed arguments
-FnDclNode *iNsTypeFindBestMethod(FnDclNode *firstmethod, INode **self, Nodes *args) {
+// Find method that best fits the passed arguments, by scanning all overloaded methods
+FnDclNode *iNsTypeScanBestMethod(FnDclNode *firstmethod, INode **self, Nodes *args) {
     // Look for best-fit method
     FnDclNode *bestmethod = NULL;
     int bestnbr = 0x7fffffff; // ridiculously high number    
@@ -69,6 +267,59 @@ FnDclNode *iNsTypeFindBestMethod(FnDclNode *firstmethod, INode **self, Nodes *ar
     return bestmethod;
 }
 
+// Find method that best fits the passed arguments
+FnDclNode *iNsTypeFindBestMethod(FnDclNode *firstmethod, INode **self, Nodes *args) {
+    MethIndex *index = iNsTypeGetIndex(firstmethod);
+    uint32_t argcnt = args ? args->used + 1 : 1;
+
+    // A single method (or a call with too many arguments) is not worth memoizing
+    if (firstmethod->nextnode == NULL || argcnt > MethMemoMaxArgs) {
+        FnDclNode *bestmethod = index ? iNsTypeFindIndexedMethod(index, self, args) : NULL;
+        return bestmethod ? bestmethod : iNsTypeScanBestMethod(firstmethod, self, args);
+    }
+
+    // Build memo key from types of self and arguments, plus the traits of
+    // each argument that also influence matching (untyped literal, lval)
+    INode *argtypes[MethMemoMaxArgs];
+    uint32_t shape = 0;
+    size_t hash = ((size_t)firstmethod) >> 3;
+    for (uint32_t i = 0; i < argcnt; ++i) {
+        INode *arg = i == 0 ? *self : nodesGet(args, i - 1);
+        argtypes[i] = iexpGetTypeDcl(arg);
+        hash = ((hash << 5) + hash) ^ iTypeHash(argtypes[i]);
+        if (arg->tag == ULitTag && (arg->flags & FlagUnkType))
+            shape |= 1 << (i << 1);
+        if (iexpIsLval(arg))
+            shape |= 2 << (i << 1);
+    }
+    hash ^= shape;
+
+    // Return memoized resolution, if we have one
+    MethMemoEntry *slotp;
+    if (gMethMemoAvail == 0)
+        iNsTypeMemoGrow();
+    methMemoFindSlot(slotp, gMethMemo, gMethMemoAvail, hash, firstmethod, argtypes, argcnt, shape);
+    if (slotp->firstmethod)
+        return slotp->bestmethod;
+
+    // Otherwise resolve the method and remember it
+    FnDclNode *bestmethod = index ? iNsTypeFindIndexedMethod(index, self, args) : NULL;
+    if (bestmethod == NULL)
+        bestmethod = iNsTypeScanBestMethod(firstmethod, self, args);
+    if (++gMethMemoUsed >= gMethMemoCeil) {
+        iNsTypeMemoGrow();
+        methMemoFindSlot(slotp, gMethMemo, gMethMemoAvail, hash, firstmethod, argtypes, argcnt, shape);
+    }
+    slotp->firstmethod = firstmethod;
+    slotp->argtypes = (INode **)memAllocBlk(argcnt * sizeof(INode *));
+    memcpy(slotp->argtypes, argtypes, argcnt * sizeof(INode *));
+    slotp->argcnt = argcnt;
+    slotp->shape = shape;
+    slotp->hash = hash;
+    slotp->bestmethod = bestmethod;
+    return bestmethod;
+}
+
 // Find method whose method signature matches exactly (except for self)
 FnDclNode *iNsTypeFindVrefMethod(FnDclNode *firstmeth, FnDclNode *matchmeth) {
     if (firstmeth == NULL || firstmeth->tag != FnDclTag) {
@@ -76,6 +327,20 @@ FnDclNode *iNsTypeFindVrefMethod(FnDclNode *firstmeth, FnDclNode *matchmeth) {
         //    &strnode->namesym->namestr, &trait->namesym->namestr, &meth->namesym->namestr);
         return 0;
     }
+    // With an index, only methods with the same arity and first parameter key can match
+    MethIndex *index = iNsTypeGetIndex(firstmeth);
+    if (index) {
+        Nodes *parms = ((FnSigNode *)matchmeth->vtype)->parms;
+        uint32_t arity = parms->used;
+        size_t key = arity > 1 ? iNsTypeMatchKey(((IExpNode *)nodesGet(parms, 1))->vtype) : 0;
+        for (MethIndexEntry *entry = index->buckets[methIndexHash(key, arity, index->avail)]; entry; entry = entry->next) {
+            if (entry->key == key && entry->arity == arity
+                && fnSigVrefEqual((FnSigNode*)entry->meth->vtype, (FnSigNode*)matchmeth->vtype))
+                return entry->meth;
+        }
+        return 0;
+    }
+
     // Look through all overloaded methods for a match
     while (firstmeth) {
         if (fnSigVrefEqual((FnSigNode*)firstmeth->vtype, (FnSigNode*)matchmeth->vtype))
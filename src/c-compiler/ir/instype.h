@@ -45,10 +45,14 @@ INode *iNsTypeFindFnField(INsTypeNode *type, Name *name);
 // 'firstmethod' is the first method that matches the name
 // We follow its forward links to find one whose parameter types best match args types
 // isvref skips type checking of the 'self' parameter for virtual references
+// Long chains are indexed by arity and first argument type, and resolutions are memoized
 FnDclNode *iNsTypeFindBestMethod(FnDclNode *firstmethod, INode **self, Nodes *args);
 
 // Find method whose method signature matches exactly (except for self)
 // return NULL if none
 FnDclNode *iNsTypeFindVrefMethod(FnDclNode *firstmeth, FnDclNode *matchmeth);
 
+// Forget all memoized method resolutions (e.g., when a method chain changes)
+void iNsTypeMemoReset();
+
 #endif
@@ -123,6 +123,10 @@ typedef struct TypeCheckState {
     INode *typenode;          // Current type (e.g., struct)
     FnDclNode *fn;            // The function and its signature/block (for returned processing)
     uint16_t scope;           // Current block scope level
+    uint16_t flags;           // e.g., TypeCheckNoFlow
 } TypeCheckState;
 
+#define TypeCheckNoFlow 0x0001  // Skip data flow analysis of function bodies
+#define TypeCheckNoRcElide 0x0002  // Keep every rc count update (no coalescing or elision)
+
 #endif
@@ -57,7 +57,9 @@ Name *refIndexName;
 Name *corelibName;
 Name *optionName;
 Name *rcName;
+Name *arcName;
 Name *soName;
+Name *arenaName;
 Name *allocMethodName;
 Name *initMethodName;
 
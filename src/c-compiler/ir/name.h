@@ -17,6 +17,7 @@
 typedef struct Name {
     INode *node;             // Node currently assigned to name
     size_t hash;             // Name's computed hash
+    int hooklvl;             // Hook table level node was hooked at (-1 = permanent)
     unsigned char namesz;    // Number of characters in the name (<=255)
     char namestr;            // First byte of name's string (the rest follows)
 } Name;
@@ -74,7 +75,9 @@ extern Name *corelibName;  // "corelib"
 extern Name *optionName;   // "Option"
 
 extern Name *rcName;       // "rc"
+extern Name *arcName;      // "arc"
 extern Name *soName;       // "so"
+extern Name *arenaName;    // "arena"
 extern Name *allocMethodName;  // "_alloc"
 extern Name *initMethodName;   // "init"
 
@@ -130,6 +130,7 @@ Name *nametblFind(char *strp, size_t strl) {
         newname->hash = hash;
         newname->namesz = (unsigned char)strl;
         newname->node = NULL;        // Node not yet known
+        newname->hooklvl = -1;
     }
     return *slotp;
 }
@@ -196,7 +197,9 @@ void nametblInit() {
     optionName = nametblFind("Option", 6);
 
     rcName = nametblFind("rc", 2);
+    arcName = nametblFind("arc", 3);
     soName = nametblFind("so", 2);
+    arenaName = nametblFind("arena", 5);
     allocMethodName = nametblFind("_alloc", 6);
     initMethodName = nametblFind("init", 4);
 }
@@ -224,11 +227,18 @@ void nametblInit() {
 // Hooking uses a LIFO stack of hook tables that preserve the old name/node pairs
 // for later restoration when unhooking. Hook tables are reused (for performance)
 // and will grow as needed.
+//
+// Module namespaces are not hooked name by name. Instead, entering a module pushes
+// its namespace onto a module lookup chain, which nametblGetNode consults lazily.
+// Each hooked name remembers the hook table level it was hooked at, so that a hook
+// made after a module was entered still shadows that module's names. This makes
+// switching modules O(1) rather than O(namespace size).
 
 // An entry for preserving the node that was in global name table for the name
 typedef struct {
     INode *node;         // The previous node to restore on pop
     Name *name;          // The name the node was indexed as
+    int hooklvl;         // The previous node's hook level
 } HookTableEntry;
 
 typedef struct {
@@ -297,6 +307,8 @@ void nametblHookNode(Name *name, INode *node) {
         HookTableEntry *entry = &tablemeta->hooktbl[tablemeta->size++];
         entry->node = name->node; // Save previous node
         entry->name = name;
+        entry->hooklvl = name->hooklvl;
+        name->hooklvl = gHookTablePos;
     }
     name->node = node; // Plug in new node
 }
@@ -318,7 +330,55 @@ void nametblHookPop() {
     int cnt = tablemeta->size;
     while (cnt--) {
         entry->name->node = entry->node;
+        entry->name->hooklvl = entry->hooklvl;
         ++entry;
     }
     --gHookTablePos;
 }
+
+// An entry in the module lookup chain
+typedef struct {
+    Namespace *ns;       // The module's namespace
+    int hooklvl;         // Hook table level current when module was entered
+} HookModEntry;
+
+static HookModEntry *gHookMods = NULL;
+static int gHookModPos = -1;
+static int gHookModSize = 0;
+
+// Push a module's namespace onto the lookup chain, along with a new hook table
+void nametblHookModPush(Namespace *ns) {
+    nametblHookPush();
+    if (++gHookModPos >= gHookModSize) {
+        HookModEntry *oldmods = gHookMods;
+        int oldsize = gHookModSize;
+        gHookModSize = oldsize == 0 ? 8 : oldsize << 1;
+        gHookMods = (HookModEntry*)memAllocBlk(gHookModSize * sizeof(HookModEntry));
+        if (oldsize)
+            memcpy(gHookMods, oldmods, oldsize * sizeof(HookModEntry));
+    }
+    gHookMods[gHookModPos].ns = ns;
+    gHookMods[gHookModPos].hooklvl = gHookTablePos;
+}
+
+// Pop innermost module from the lookup chain, unhooking its hook table
+void nametblHookModPop() {
+    nametblHookPop();
+    --gHookModPos;
+}
+
+// Return the node currently visible for a name (or NULL if none):
+// a name hooked since the innermost module holding that name was entered wins,
+// otherwise the module's own node does.
+INode *nametblGetNode(Name *name) {
+    int pos = gHookModPos;
+    while (pos >= 0) {
+        HookModEntry *modentry = &gHookMods[pos--];
+        if (name->node && name->hooklvl >= modentry->hooklvl)
+            return name->node;
+        INode *node = namespaceFind(modentry->ns, name);
+        if (node)
+            return node;
+    }
+    return name->node;
+}
@@ -48,4 +48,11 @@ void nametblHookNode(Name *name, INode *node);
 void nametblHookNamespace(Namespace *ns);
 void nametblHookPop();
 
+// Module namespaces are hooked lazily: entering a module pushes its namespace
+// onto a lookup chain, rather than hooking each of its names.
+void nametblHookModPush(Namespace *ns);
+void nametblHookModPop();
+// Return the node a name currently refers to, consulting hooks and module chain
+INode *nametblGetNode(Name *name);
+
 #endif
@@ -21,6 +21,7 @@ FnDclNode *newFnDclNode(Name *namesym, uint16_t flags, INode *type, INode *val)
     node->llvmvar = NULL;
     node->genname = namesym? &namesym->namestr : "";
     node->nextnode = NULL;
+    node->overloads = NULL;
     node->genericinfo = NULL;
     return node;
 }
@@ -32,6 +33,7 @@ INode *cloneFnDclNode(CloneState *cstate, FnDclNode *oldfn) {
     memcpy(newnode, oldfn, sizeof(FnDclNode));
     newnode->genericinfo = NULL;
     newnode->nextnode = NULL; // clear out linkages
+    newnode->overloads = NULL;
     newnode->vtype = cloneNode(cstate, oldfn->vtype);
     newnode->value = cloneNode(cstate, oldfn->value);
     cloneDclPop(dclpos);
@@ -113,10 +115,84 @@ void fnImplicitReturn(INode *rettype, BlockNode *blk) {
     }
 }
 
+// Function bodies are largely independent of each other once all signatures and
+// types are known. So, module type checking queues each function body found,
+// and only type checks and flow analyzes them after the module's declarations.
+// This queue is the unit of work for that body pass: each entry preserves
+// the type check context (e.g., the enclosing type) that the function was found in.
+//
+// The queue is drained on one thread. Checking a body is not yet independent of
+// other bodies, so workers cannot share the queue:
+// - It lazily type checks the struct/trait declarations it uses (marking them checked)
+// - It instantiates generics into shared IR, queuing more bodies here
+// - It resolves overloads through gMethMemo (instype.c) and gFnCallOpCache (fncall.c)
+// - It interns types in the type table (typetbl.c)
+// - It allocates from the process-wide arenas in memory.c and counts errors in error.c
+// Each needs to become per-thread or locked before bodies can be checked concurrently.
+typedef struct {
+    FnDclNode *fnnode;          // The function whose body is to be checked
+    TypeCheckState tstate;      // Type check context at the time it was queued
+} FnBodyWork;
+
+static FnBodyWork *gFnBodyQueue = NULL;
+static size_t gFnBodyQueueSz = 0;
+static size_t gFnBodyQueueHead = 0;     // Next queued body to check
+static size_t gFnBodyQueueTail = 0;     // Next free slot
+
+// Add a function's body to the queue of bodies to check
+void fnDclQueueBody(TypeCheckState *pstate, FnDclNode *fnnode) {
+    // Ensure we have room for another body
+    if (gFnBodyQueueTail >= gFnBodyQueueSz) {
+        FnBodyWork *oldqueue = gFnBodyQueue;
+        size_t oldsize = gFnBodyQueueSz;
+        gFnBodyQueueSz = oldsize == 0 ? 256 : oldsize << 1;
+        gFnBodyQueue = (FnBodyWork*)memAllocBlk(gFnBodyQueueSz * sizeof(FnBodyWork));
+        if (oldsize)
+            memcpy(gFnBodyQueue, oldqueue, oldsize * sizeof(FnBodyWork));
+    }
+    FnBodyWork *work = &gFnBodyQueue[gFnBodyQueueTail++];
+    work->fnnode = fnnode;
+    work->tstate = *pstate;
+}
+
+// Type check and data flow analyze a function's body
+void fnDclCheckBody(TypeCheckState *pstate, FnDclNode *fnnode) {
+    // Syntactic sugar: Turn implicit returns into explicit returns
+    fnImplicitReturn(((FnSigNode*)fnnode->vtype)->rettype, (BlockNode *)fnnode->value);
+
+    // Type check/inference of the function's logic
+    FnDclNode *svFn = pstate->fn;
+    pstate->fn = fnnode;
+    inodeTypeCheck(pstate, &fnnode->value, noCareType);
+    pstate->fn = svFn;
+
+    // Immediately perform the data flow pass for this function
+    // We run data flow separately as it requires type info which is inferred bottoms-up
+    if (errors || (pstate->flags & TypeCheckNoFlow))
+        return;
+    FlowState fstate;
+    flowInit(&fstate, (FnSigNode *)fnnode->vtype);
+    fstate.coalesce = !(pstate->flags & TypeCheckNoRcElide);
+    blockFlow(&fstate, (BlockNode **)&fnnode->value);
+}
+
+// Type check and flow analyze all queued function bodies, in the order queued.
+// Checking a body may queue more (e.g., instantiated generic functions).
+void fnDclCheckQueuedBodies() {
+    while (gFnBodyQueueHead < gFnBodyQueueTail) {
+        // Copy out work, as checking the body may grow (move) the queue
+        FnBodyWork work = gFnBodyQueue[gFnBodyQueueHead++];
+        fnDclCheckBody(&work.tstate, work.fnnode);
+    }
+    gFnBodyQueueHead = gFnBodyQueueTail = 0;
+}
+
 // Type checking a function's logic does more than you might think:
 // - Turn implicit returns into explicit returns
 // - Perform type checking for all statements
 // - Perform data flow analysis on variables and references
+// The signature is checked now, but the body is queued for checking
+// after the module's declarations (see fnDclCheckQueuedBodies)
 void fnDclTypeCheck(TypeCheckState *pstate, FnDclNode *fnnode) {
     // Wait until a generic function is instantiated before type checking
     if (fnnode->genericinfo)
@@ -135,21 +211,5 @@ void fnDclTypeCheck(TypeCheckState *pstate, FnDclNode *fnnode) {
             errorMsgNode((INode*)fnnode, ErrorInvType, "self parameter for a method must match, or be a reference to, its type");
     }
 
-    // Syntactic sugar: Turn implicit returns into explicit returns
-    fnImplicitReturn(((FnSigNode*)fnnode->vtype)->rettype, (BlockNode *)fnnode->value);
-
-    // Type check/inference of the function's logic
-    FnDclNode *svFn = pstate->fn;
-    pstate->fn = fnnode;
-    inodeTypeCheck(pstate, &fnnode->value, noCareType);
-    pstate->fn = svFn;
-
-    // Immediately perform the data flow pass for this function
-    // We run data flow separately as it requires type info which is inferred bottoms-up
-    if (errors)
-        return;
-    FlowState fstate;
-    fstate.fnsig = (FnSigNode *)fnnode->vtype;
-    fstate.scope = 1;
-    blockFlow(&fstate, (BlockNode **)&fnnode->value);
+    fnDclQueueBody(pstate, fnnode);
 }
@@ -15,6 +15,7 @@ typedef struct FnDclNode {
     LLVMValueRef llvmvar;         // LLVM's handle for a declared variable (for generation)
     char *genname;                // Name of the function as known to the linker
     struct FnDclNode *nextnode;   // Link to next overloaded method with the same name (or NULL)
+    struct MethIndex *overloads;  // Index of overloaded methods (first method only, built lazily)
     GenericInfo *genericinfo;     // Link to generic parms, etc (or NULL if not generic)
     uint16_t vtblidx;             // Method ptr's index in the type's vtable
 } FnDclNode;
@@ -34,6 +35,13 @@ void fnDclNameRes(NameResState *pstate, FnDclNode *name);
 // - Turn implicit returns into explicit returns
 // - Perform type checking for all statements
 // - Perform data flow analysis on variables and references
+// The function's body is queued, to be checked by fnDclCheckQueuedBodies()
 void fnDclTypeCheck(TypeCheckState *pstate, FnDclNode *fnnode);
 
+// Type check and data flow analyze a function's body
+void fnDclCheckBody(TypeCheckState *pstate, FnDclNode *fnnode);
+
+// Type check and flow analyze all queued function bodies
+void fnDclCheckQueuedBodies();
+
 #endif
@@ -22,19 +22,19 @@ ModuleNode *newModuleNode() {
 }
 
 // Add a newly parsed named node to the module:
-// - We hook all names in global name table at parse time to check for name dupes and
+// - We add all names to the module's namespace at parse time to check for name dupes and
 //     because permissions and allocators do not support forward references
+//     (the namespace is visible through the name table's module lookup chain)
 // - We remember all public names for later resolution of qualified names
 void modAddNamedNode(ModuleNode *mod, Name *name, INode *node) {
 
-    // Hook into global name table (and add to namednodes), if not already there
-    if (!name->node) {
-        nametblHookNode(name, (INode*)node);
+    // Add to module's namespace (visible via module lookup chain), if not already there
+    INode *dupnode = nametblGetNode(name);
+    if (!dupnode)
         namespaceSet(&mod->namespace, name, node);
-    }
     else {
         errorMsgNode((INode *)node, ErrorDupName, "Global name is already defined. Duplicates not allowed.");
-        errorMsgNode((INode*)name->node, ErrorDupName, "This is the conflicting definition for that name.");
+        errorMsgNode(dupnode, ErrorDupName, "This is the conflicting definition for that name.");
     }
 }
 
@@ -79,13 +79,12 @@ void modPrint(ModuleNode *mod) {
 
 // Unhook old module's names, hook new module's names
 // (works equally well from parent to child or child to parent
+// Module names are looked up lazily via the module chain, so this is O(1)
 void modHook(ModuleNode *oldmod, ModuleNode *newmod) {
     if (oldmod)
-        nametblHookPop();
-    if (newmod) {
-        nametblHookPush();
-        nametblHookNamespace(&newmod->namespace);
-    }
+        nametblHookModPop();
+    if (newmod)
+        nametblHookModPush(&newmod->namespace);
 }
 
 // Name resolution of the module node
@@ -156,4 +155,8 @@ void modTypeCheck(TypeCheckState *pstate, ModuleNode *mod) {
             inodeTypeCheckAny(pstate, nodesp);
         }
     }
+
+    // Finally, type check and flow analyze all function bodies found above,
+    // now that all the signatures and types they depend on are known
+    fnDclCheckQueuedBodies();
 }
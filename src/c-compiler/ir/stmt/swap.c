@@ -61,6 +61,8 @@ void swapTypeCheck(TypeCheckState *pstate, SwapNode *node) {
 // - lval and rval need to be mutable.
 void swapFlow(FlowState *fstate, SwapNode **nodep) {
     SwapNode *node = *nodep;
+    flowUseLval(node->lval);
+    flowUseLval(node->rval);
 
     uint16_t lvalscope;
     INode *lvalperm;
@@ -24,6 +24,10 @@ VarDclNode *newVarDclNode(Name *namesym, uint16_t tag, INode *perm) {
     name->genname = &namesym->namestr;
     name->flowflags = 0;
     name->flowtempflags = 0;
+    name->flowscope = 0;
+    name->flowalias = NULL;
+    name->rangelimit = NULL;
+    name->rangeloop = NULL;
     return name;
 }
 
@@ -40,6 +44,10 @@ VarDclNode *newVarDclFull(Name *namesym, uint16_t tag, INode *type, INode *perm,
     name->llvmvar = NULL;
     name->flowflags = 0;
     name->flowtempflags = 0;
+    name->flowscope = 0;
+    name->flowalias = NULL;
+    name->rangelimit = NULL;
+    name->rangeloop = NULL;
     return name;
 }
 
@@ -78,9 +86,10 @@ void varDclNameRes(NameResState *pstate, VarDclNode *name) {
 
     // Variable declaration within a block is a local variable
     if (pstate->scope > 0) {
-        if (name->namesym->node && pstate->scope == ((VarDclNode*)name->namesym->node)->scope) {
+        INode *dupnode = nametblGetNode(name->namesym);
+        if (dupnode && pstate->scope == ((VarDclNode*)dupnode)->scope) {
             errorMsgNode((INode *)name, ErrorDupName, "Name is already defined. Only one allowed.");
-            errorMsgNode((INode*)name->namesym->node, ErrorDupName, "This is the conflicting definition for that name.");
+            errorMsgNode(dupnode, ErrorDupName, "This is the conflicting definition for that name.");
         }
         else {
             name->scope = pstate->scope;
@@ -122,10 +131,10 @@ void varDclTypeCheck(TypeCheckState *pstate, VarDclNode *name) {
 
 // Perform data flow analysis
 void varDclFlow(FlowState *fstate, VarDclNode **vardclnode) {
-    flowAddVar(*vardclnode);
+    flowAddVar(fstate, *vardclnode);
     if ((*vardclnode)->value) {
         flowLoadValue(fstate, &((*vardclnode)->value));
-        flowHandleMoveOrCopy(&((*vardclnode)->value));  // initialization copies/moves value
+        flowHandleMoveOrCopy(fstate, &((*vardclnode)->value));  // initialization copies/moves value
         (*vardclnode)->flowtempflags |= VarInitialized;
     }
 }
@@ -19,11 +19,21 @@ typedef struct VarDclNode {
     uint16_t index;            // index within this scope (e.g., parameter number)
     uint16_t flowflags;        // Data flow pass permanent flags
     uint16_t flowtempflags;    // Data flow pass temporary flags
+    uint16_t flowscope;        // Data flow pass: block scope the variable was declared in
+    INode *flowalias;          // Data flow pass: rc alias node that later copies coalesce into
+    INode *rangelimit;         // 'each' range variable: loop's limit (NULL once mutated elsewhere)
+    INode *rangeloop;          // 'each' range variable: the loop block it steps through
 } VarDclNode;
 
+enum VarFlowPerm {
+    VarRangeIncl = 0x0001       // 'each' range variable may equal its rangelimit (<=)
+};
+
 enum VarFlowTemp {
     VarInitialized = 0x0001,    // Variable has been initialized
-    VarMoved = 0x0002           // Variable has been moved
+    VarMoved = 0x0002,          // Variable has been moved
+    VarLastAliased = 0x0004,    // Nothing has used the rc variable since its flowalias copy
+    VarBorrowed = 0x0008        // Variable has been borrowed from (so its rc count must be kept)
 };
 
 VarDclNode *newVarDclNode(Name *namesym, uint16_t tag, INode *perm);
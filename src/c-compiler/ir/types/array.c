@@ -14,6 +14,7 @@ ArrayNode *newArrayNode() {
     anode->llvmtype = NULL;
     anode->dimens = newNodes(1);
     anode->elems = newNodes(1);
+    anode->packed = NULL;
     return anode;
 }
 
@@ -64,6 +65,19 @@ void arrayPrint(ArrayNode *node) {
         if (cnt > 1)
             inodeFprint(", ");
     }
+    if (node->packed) {
+        ArrayLitPack *pack = node->packed;
+        INode *elemtype = arrayLitPackType(pack);
+        for (uint32_t i = 0; i < pack->used; ++i) {
+            if (pack->littag == ULitTag)
+                inodeFprint("%llu", (unsigned long long)pack->uintlits[i]);
+            else
+                inodeFprint("%g", pack->floatlits[i]);
+            inodePrintNode(elemtype);
+            if (i + 1 < pack->used)
+                inodeFprint(", ");
+        }
+    }
     inodeFprint("]");
 }
 
@@ -73,7 +87,7 @@ void arrayNameRes(NameResState *pstate, ArrayNode *node) {
     uint32_t cnt;
     for (nodesFor(node->elems, cnt, nodesp))
         inodeNameRes(pstate, nodesp);
-    if (node->elems->used > 0 && !isTypeNode(nodesGet(node->elems, 0)))
+    if (node->packed || (node->elems->used > 0 && !isTypeNode(nodesGet(node->elems, 0))))
         node->tag = ArrayLitTag; // We have an array literal, not array type
     for (nodesFor(node->dimens, cnt, nodesp))
         inodeNameRes(pstate, nodesp);
@@ -13,6 +13,7 @@ typedef struct {
     ITypeNodeHdr;
     Nodes *dimens;    // Dimensions of the array
     Nodes *elems;     // Either a list of elements, or the element type
+    struct ArrayLitPack *packed;  // Packed numeric literal elements (or NULL)
 } ArrayNode;
 
 // Create a new array node
@@ -25,6 +25,8 @@ void *refTypeInfoAlloc() {
     refinfo->llvmtyperef = NULL;
     refinfo->structype = NULL;
     refinfo->ptrstructype = NULL;
+    refinfo->regionfield = refinfo->permfield = -1;
+    refinfo->valuefield = 0;
     return (void*)refinfo;
 }
 
@@ -47,6 +49,14 @@ void refAdoptInfections(RefNode *refnode) {
     if (refnode->perm == (INode*)mutPerm || refnode->perm == (INode*)roPerm 
         || (refnode->vtexp->flags & ThreadBound))
         refnode->flags |= ThreadBound;
+    // rc's counter is not updated atomically, so its references must stay in their thread (unlike arc)
+    if (refnode->region->tag == TypeNameUseTag && ((NameUseNode*)refnode->region)->dclnode
+        && isRegion(refnode->region, rcName))
+        refnode->flags |= ThreadBound;
+    // arena references point into their thread's chunks, which only that thread releases
+    if (refnode->region->tag == TypeNameUseTag && ((NameUseNode*)refnode->region)->dclnode
+        && isRegion(refnode->region, arenaName))
+        refnode->flags |= ThreadBound;
 }
 
 // Create a reference node based on fully-known type parameters
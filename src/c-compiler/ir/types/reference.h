@@ -11,16 +11,13 @@
 // Metadata for normalized reference type
 typedef struct {
     LLVMTypeRef llvmtyperef;
-    LLVMTypeRef structype;
+    LLVMTypeRef structype;     // Layout of an allocation: region and perm (if not zero-size), then value
     LLVMTypeRef ptrstructype;
+    int regionfield;           // structype's field index for region (-1 if elided)
+    int permfield;             // structype's field index for permission (-1 if elided)
+    int valuefield;            // structype's field index for value (always last)
 } RefTypeInfo;
 
-enum ManagedRefFields {
-    RegionField,
-    PermField,
-    ValueField
-};
-
 // Reference node: used for reference type, allocation or borrow node
 typedef struct {
     ITypeNodeHdr;
@@ -16,6 +16,11 @@ int isRegion(INode *region, Name *namesym) {
     return 0;
 }
 
+// Is region reference counted (rc or its atomic counterpart arc)?
+int isRcRegion(INode *region) {
+    return isRegion(region, rcName) || isRegion(region, arcName);
+}
+
 int regionIsPtrU8(RefNode *ptrnode) {
     if (ptrnode->tag != PtrTag)
         return 0;
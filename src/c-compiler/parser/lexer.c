@@ -22,26 +22,54 @@
 #include <ctype.h>
 #include <stdio.h>
 
-// Global lexer state
-Lexer *lex = NULL;        // Current lexer
-
-// Inject a new source stream into the lexer
-void lexInject(char *src, char *url) {
-    Lexer *prev;
+// Global lexer options
+static int gLexPrelex = 0;   // Pre-lex each new lexer's source into a token buffer?
+
+// Build the source's line index: the offset of every line's start.
+// memchr does the scanning for newlines a word (or vector) at a time.
+void lexerIndexLines(Lexer *lex) {
+    char *src = lex->source;
+    size_t srcsize = strlen(src);
+    uint32_t alloc = (uint32_t)(srcsize >> 5) + 16;
+    uint32_t *linestarts = (uint32_t*)memAllocBlk(alloc * sizeof(uint32_t));
+    uint32_t nlines = 0;
+    linestarts[nlines++] = 0;
+    char *srcp = src;
+    char *srcend = src + srcsize;
+    while ((srcp = memchr(srcp, '\n', srcend - srcp))) {
+        if (nlines >= alloc) {
+            uint32_t *oldstarts = linestarts;
+            alloc <<= 1;
+            linestarts = (uint32_t*)memAllocBlk(alloc * sizeof(uint32_t));
+            memcpy(linestarts, oldstarts, nlines * sizeof(uint32_t));
+        }
+        linestarts[nlines++] = (uint32_t)(++srcp - src);
+    }
+    lex->linestarts = linestarts;
+    lex->nlines = nlines;
+    lex->srcend = srcend;
+}
 
-    // Obtain next lexer block via link chain or allocation
-    prev = lex;
-    if (lex == NULL)
-        lex = (Lexer*) memAllocBlk(sizeof(Lexer));
-    else if (lex->next == NULL) {
-        lex->next = (Lexer*) memAllocBlk(sizeof(Lexer));
-        lex = lex->next;
+// Return the line number (starting with 1) containing source offset,
+// found by binary search of the line index. Also return start of line in *linep.
+uint32_t lexerLineOf(Lexer *lex, uint32_t srcoff, char **linep) {
+    uint32_t low = 0;
+    uint32_t high = lex->nlines;
+    // Find last line that starts at or before srcoff
+    while (high - low > 1) {
+        uint32_t mid = (low + high) >> 1;
+        if (lex->linestarts[mid] <= srcoff)
+            low = mid;
+        else
+            high = mid;
     }
-    else
-        lex = lex->next; // Re-use an old lexer block
-    lex->next = NULL;
-    lex->prev = prev;
+    if (linep)
+        *linep = lex->source + lex->linestarts[low];
+    return low + 1;
+}
 
+// Initialize a lexer to start lexing a source stream (reusing its block stack)
+void lexerInit(Lexer *lex, char *src, char *url) {
     // Skip over UTF8 Byte-order mark (BOM = U+FEFF) at start of source, if there is
     if (*src=='\xEF' && *(src+1)=='\xBB' && *(src+2)=='\xBF')
         src += 3;
@@ -50,23 +78,39 @@ void lexInject(char *src, char *url) {
     lex->url = url;
     lex->fname = fileName(url);
     lex->source = src;
+    lexerIndexLines(lex);
 
     // Initialize lexer context
-    lex->srcp = lex->tokp = lex->linep = src;
-    lex->linenbr = 1;
+    lex->srcp = lex->tokp = src;
     lex->flags = 0;
     lex->strexpr = StrExprOff;
     lex->tokPosInLine = 0;
     lex->indentch = '\0';
     lex->curindent = 0;
     lex->stmtindent = 0;
+    if (lex->blkStackSz == 0) {
+        lex->blkStackSz = 16;
+        lex->blkStack = (LexBlockInfo*)memAllocBlk(lex->blkStackSz * sizeof(LexBlockInfo));
+    }
     lex->blkStackLvl = 0;
     lex->blkStack[0].blkindent = 0;
     lex->blkStack[0].paranscnt = 0;
     lex->blkStack[0].blkmode = FreeFormBlock;
+    lex->tokbuf = NULL;
 
     // Prime the pump with the first token
-    lexNextToken();
+    lexerNextToken(lex);
+    if (gLexPrelex)
+        lexerPrelex(lex);
+}
+
+// Create a new lexer for a source stream.
+// Each source gets its own lexer, as nodes refer to it for their source position
+Lexer *newLexer(char *src, char *url) {
+    Lexer *lexer = (Lexer*) memAllocBlk(sizeof(Lexer));
+    lexer->blkStackSz = 0;
+    lexerInit(lexer, src, url);
+    return lexer;
 }
 
 // Add a reserved identifier and its node to the global name table
@@ -129,36 +173,39 @@ void keywordInit() {
 // Initialize lexer
 void lexInit(ConeOptions *opt) {
     fileSearchPaths = opt->package_search_paths;
-    lexInject("", "init");
     keywordInit();
+    gLexPrelex = opt->prelex;
 }
 
-// Inject a new source stream into the lexer
-void lexInjectFile(char *url) {
+// Create a new lexer for a source file.
+// A relative url is found relative to the source of the lexer it is being loaded from, if any.
+Lexer *newLexerFile(Lexer *from, char *url) {
     char *src;
     char *fn;
     timerBegin(LoadTimer);
     // Load specified source file
-    src = fileLoadSrc(lex? lex->url : NULL, url, &fn);
+    src = fileLoadSrc(from? from->url : NULL, url, &fn);
     if (!src)
         errorExit(ExitNF, "Cannot find or read source file %s", url);
 
     timerBegin(ParseTimer);
-    lexInject(src, fn);
-}
-
-// Restore previous lexer's stream
-void lexPop() {
-    if (lex)
-        lex = lex->prev;
+    return newLexer(src, fn);
 }
 
 // ******  SIGNIFICANT WHITESPACE HANDLING ***********
 
 // Parser indicates new block starts here, e.g., '{'
-void lexBlockStart(LexBlockMode mode) {
-    if (lex->blkStackLvl >= LEX_MAX_BLOCKS)
-        errorExit(ExitIndent, "Too many indent levels in source file.");
+void lexerBlockStart(Lexer *lex, LexBlockMode mode) {
+    if (lex->blkStackLvl + 1 >= lex->blkStackSz) {
+        // Double block stack size, copying over old data
+        if (lex->blkStackSz >= LEX_MAX_BLOCKS)
+            errorExit(ExitIndent, "Too many indent levels in source file.");
+        LexBlockInfo *oldstack = lex->blkStack;
+        int oldsize = lex->blkStackSz;
+        lex->blkStackSz <<= 1;
+        lex->blkStack = (LexBlockInfo*)memAllocBlk(lex->blkStackSz * sizeof(LexBlockInfo));
+        memcpy(lex->blkStack, oldstack, oldsize * sizeof(LexBlockInfo));
+    }
     int level = ++lex->blkStackLvl;
     lex->blkStack[level].blkindent = lex->stmtindent;
     lex->blkStack[level].paranscnt = 0;
@@ -166,69 +213,67 @@ void lexBlockStart(LexBlockMode mode) {
 }
 
 // Parser indicates block finishes here, e.g., '}'
-void lexBlockEnd() {
+void lexerBlockEnd(Lexer *lex) {
     int level = lex->blkStackLvl--;
     lex->stmtindent = lex->blkStack[level].blkindent;
 }
 
 // Does block end here, based on block mode?
-int lexIsBlockEnd() {
+int lexerIsBlockEnd(Lexer *lex) {
     switch (lex->blkStack[lex->blkStackLvl].blkmode) {
     case FreeFormBlock: 
         return 0;
     case SameStmtBlock:
-        if (lexIsToken(EofToken))
+        if (lexerIsToken(lex, EofToken))
             return 1;
         // It is not end-of-block if we are still on same line as block started on
-        if (!lexIsEndOfLine()) 
+        if (!lexerIsEndOfLine(lex)) 
             return 0;
         // Switch mode for next line, using indentation to drive end-of-block
         lex->blkStack[lex->blkStackLvl].blkmode = SigIndentBlock;
         // Deliberate fallthrough
     case SigIndentBlock:
-        if (lexIsToken(EofToken))
+        if (lexerIsToken(lex, EofToken))
             return 1;
-        return lexIsEndOfLine() && lex->curindent <= lex->blkStack[lex->blkStackLvl].blkindent;
+        return lexerIsEndOfLine(lex) && lex->curindent <= lex->blkStack[lex->blkStackLvl].blkindent;
     }
     return 0;
 }
 
 // Decrement counter for parentheses/brackets
-void lexDecrParens() {
+void lexerDecrParens(Lexer *lex) {
     if (lex->blkStack[lex->blkStackLvl].paranscnt > 0)
         --lex->blkStack[lex->blkStackLvl].paranscnt;
 }
 
 // Increment counter for parentheses/brackets
-void lexIncrParens() {
+void lexerIncrParens(Lexer *lex) {
     ++lex->blkStack[lex->blkStackLvl].paranscnt;
 }
 
 // Is next token at start of line?
-int lexIsEndOfLine() {
+int lexerIsEndOfLine(Lexer *lex) {
     return lex->tokPosInLine == 0;
 }
 
 // Parser indicates the start of a new statement
 // This allows lexIsStmtBreak to know if a continuation line is indented
-void lexStmtStart() {
+void lexerStmtStart(Lexer *lex) {
     lex->stmtindent = lex->curindent;
 }
 
 // Return true if current token is first on a line that has not been indented
 // and does not have any open parentheses or brackets
-int lexIsStmtBreak() {
-    return lexIsEndOfLine() && lex->curindent <= lex->stmtindent 
+int lexerIsStmtBreak(Lexer *lex) {
+    return lexerIsEndOfLine(lex) && lex->curindent <= lex->stmtindent 
         && lex->blkStack[lex->blkStackLvl].paranscnt == 0;
 }
 
 // Handle new line character.
 // Update lexer state, including indentation count for current line
-char *lexNewLine(char *srcp) {
+char *lexNewLine(Lexer *lex, char *srcp) {
     srcp++;
-    lex->linep = srcp;
     lex->tokPosInLine = 0;
-    ++lex->linenbr;
     // Count line's indentation
     lex->curindent = 0;
     while (1) {
@@ -244,7 +289,7 @@ char *lexNewLine(char *srcp) {
             case '\t':
                 if (*srcp != lex->indentch) {
                     lex->tokp = srcp;
-                    errorMsgLex(WarnIndent, "Inconsistent indentation - use either spaces or tabs, not both.");
+                    errorMsgLexer(lex, WarnIndent, "Inconsistent indentation - use either spaces or tabs, not both.");
                     lex->indentch = '*'; // Only issue warning once
                 }
                 break;
@@ -263,7 +308,7 @@ char *lexNewLine(char *srcp) {
 // ******  TOKEN-SPECIFIC LEXING **********
 
 /** Return value of hex digit, or -1 if not correct */
-char *lexHexDigits(int cnt, char *srcp, uint64_t *val) {
+char *lexHexDigits(Lexer *lex, int cnt, char *srcp, uint64_t *val) {
     *val = 0;
     while (cnt--) {
         *val <<= 4;
@@ -274,7 +319,7 @@ char *lexHexDigits(int cnt, char *srcp, uint64_t *val) {
         else if (*srcp>='a' && *srcp<='f')
             *val += *srcp++ - ('a' - 10);
         else {
-            errorMsgLex(ErrorBadTok, "Invalid hexadecimal character '%c'", *srcp);
+            errorMsgLexer(lex, ErrorBadTok, "Invalid hexadecimal character '%c'", *srcp);
             return srcp;
         }
     }
@@ -282,7 +327,7 @@ char *lexHexDigits(int cnt, char *srcp, uint64_t *val) {
 }
 
 /** Turn escape sequence into a single character */
-char *lexScanEscape(char *srcp, uint64_t *charval) {
+char *lexScanEscape(Lexer *lex, char *srcp, uint64_t *charval) {
     switch (*++srcp) {
     case 'a': *charval = '\a'; return ++srcp;
     case 'b': *charval = '\b'; return ++srcp;
@@ -296,18 +341,18 @@ char *lexScanEscape(char *srcp, uint64_t *charval) {
     case '\\': *charval = '\\'; return ++srcp;
     case ' ': *charval = ' '; return ++srcp;
     case '\0': *charval = '\0'; return ++srcp;
-    case 'x': return lexHexDigits(2, ++srcp, charval);
-    case 'u': return lexHexDigits(4, ++srcp, charval);
-    case 'U': return lexHexDigits(8, ++srcp, charval);
+    case 'x': return lexHexDigits(lex, 2, ++srcp, charval);
+    case 'u': return lexHexDigits(lex, 4, ++srcp, charval);
+    case 'U': return lexHexDigits(lex, 8, ++srcp, charval);
     default:
-        errorMsgLex(ErrorBadTok, "Invalid escape sequence '%c'", *srcp);
+        errorMsgLexer(lex, ErrorBadTok, "Invalid escape sequence '%c'", *srcp);
         *charval = *srcp++;
         return srcp;
     }
 }
 
 /** Tokenize a lifetime annotation or character literal */
-void lexScanChar(char *srcp) {
+void lexScanChar(Lexer *lex, char *srcp) {
     char *srcbeg = srcp;
     lex->tokp = srcp++;
 
@@ -330,7 +375,7 @@ void lexScanChar(char *srcp) {
     int isUnicode = 0;
     if (*srcp == '\\') {
         isUnicode = *(srcp + 1) == 'u' || *(srcp + 1) == 'U';
-        srcp = lexScanEscape(srcp, &lex->val.uintlit);
+        srcp = lexScanEscape(lex, srcp, &lex->val.uintlit);
     }
     else
         lex->val.uintlit = *srcp++;
@@ -358,13 +403,13 @@ void lexScanChar(char *srcp) {
         }
         ++srcp;
     }
-    errorMsgLex(ErrorBadTok, "Invalid lifetime or too-long character literal");
+    errorMsgLexer(lex, ErrorBadTok, "Invalid lifetime or too-long character literal");
     lex->langtype = (INode*)u8Type;
     lex->toktype = IntLitToken;
     lex->srcp = srcp;
 }
 
-void lexScanString(char *srcp) {
+void lexScanString(Lexer *lex, char *srcp) {
     uint64_t uchar;
     lex->tokp = srcp++;
 
@@ -402,7 +447,7 @@ void lexScanString(char *srcp) {
         else {
             // Handle escaped character(s), including unicode
             int isUnicode = *(srcp + 1) == 'u' || *(srcp + 1) == 'U';
-            srcp = lexScanEscape(srcp, &uchar);
+            srcp = lexScanEscape(lex, srcp, &uchar);
             if (!isUnicode || uchar < 0x80) {
                 *newp++ = (unsigned char)uchar;
                 srclen++;
@@ -436,8 +481,108 @@ void lexScanString(char *srcp) {
     lex->srcp = srcp;
 }
 
+// SWAR (SIMD within a register) digit handling works on 8 little-endian bytes at a time
+#if !defined(__BYTE_ORDER__) || __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define LEX_SWAR_DIGITS
+#endif
+
+#ifdef LEX_SWAR_DIGITS
+// Return true if all 8 bytes are ascii decimal digits
+static inline int lexIsEightDigits(uint64_t val) {
+    return ((val & 0xF0F0F0F0F0F0F0F0) | (((val + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4))
+        == 0x3333333333333333;
+}
+
+// Convert 8 ascii decimal digits (first digit in lowest byte) to their value
+static inline uint64_t lexEightDigitsValue(uint64_t val) {
+    const uint64_t mask = 0x000000FF000000FF;
+    const uint64_t mul1 = 0x000F424000000064; // 100 + (1000000 << 32)
+    const uint64_t mul2 = 0x0000271000000001; // 1 + (10000 << 32)
+    val -= 0x3030303030303030;
+    val = (val * 10) + (val >> 8);  // pairs of digits
+    return (((val & mask) * mul1) + (((val >> 16) & mask) * mul2)) >> 32;
+}
+#endif
+
+// Exactly representable powers of ten, for the float fast path
+static const double lexPow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+// Try the fast path for a decimal float literal: when its significant digits fit
+// exactly in a double's mantissa and the power of ten is exact, a single
+// multiply or divide gives the correctly rounded result (Clinger's fast path).
+// Return 0 if the literal needs the slow path.
+int lexToFloatFast(char *srcp, char *srcend, double *result) {
+    uint64_t mantissa = 0;
+    int ndigits = 0;      // Significant digits accumulated in mantissa
+    int exp10 = 0;
+    int seendot = 0;
+
+    // Hexadecimal and binary literals go the slow way
+    if (*srcp == '0' && srcp + 1 < srcend
+        && (srcp[1] == 'x' || srcp[1] == 'X' || srcp[1] == 'b' || srcp[1] == 'B'))
+        return 0;
+
+    // Mantissa digits, skipping underscores and leading zeros
+    for (; srcp < srcend; ++srcp) {
+        if (*srcp >= '0' && *srcp <= '9') {
+            if (mantissa == 0 && *srcp == '0') {
+                if (seendot)
+                    --exp10;
+                continue;
+            }
+            if (++ndigits > 19)
+                return 0;
+            mantissa = mantissa * 10 + (*srcp - '0');
+            if (seendot)
+                --exp10;
+        }
+        else if (*srcp == '_')
+            continue;
+        else if (*srcp == '.' && !seendot)
+            seendot = 1;
+        else
+            break;
+    }
+
+    // Optional decimal exponent
+    if (srcp < srcend && (*srcp == 'e' || *srcp == 'E')) {
+        int expneg = 0;
+        int expval = 0;
+        if (++srcp < srcend && (*srcp == '-' || *srcp == '+'))
+            expneg = *srcp++ == '-';
+        if (srcp >= srcend || *srcp < '0' || *srcp > '9')
+            return 0;
+        for (; srcp < srcend && ((*srcp >= '0' && *srcp <= '9') || *srcp == '_'); ++srcp) {
+            if (*srcp == '_')
+                continue;
+            if (expval > 10000)
+                return 0;
+            expval = expval * 10 + (*srcp - '0');
+        }
+        exp10 += expneg ? -expval : expval;
+    }
+    else if (srcp < srcend && (*srcp == 'p' || *srcp == 'P'))
+        return 0;
+
+    if (mantissa == 0) {
+        *result = 0.0;
+        return 1;
+    }
+    if (mantissa > ((uint64_t)1 << 53) || exp10 < -22 || exp10 > 22)
+        return 0;
+    *result = exp10 >= 0 ? (double)mantissa * lexPow10[exp10] : (double)mantissa / lexPow10[-exp10];
+    return 1;
+}
+
 // Convert ascii float number to double float
 double lexToFloat(char *srcp, char *srcend) {
+    double result;
+    if (lexToFloatFast(srcp, srcend, &result))
+        return result;
+
     // Copy ascii literal to number, stripping out underscores
     char number[1000];
     if (srcend - srcp > 999)
@@ -450,11 +595,11 @@ double lexToFloat(char *srcp, char *srcend) {
     }
     *nbrp = '\0';
 
-    return atof(number);
+    return strtod(number, NULL);
 }
 
 /** Tokenize an integer or floating point number */
-void lexScanNumber(char *srcp) {
+void lexScanNumber(Lexer *lex, char *srcp) {
 
     char *srcbeg;        // Pointer to the start of the token
     uint64_t base;        // Radix for integer (10 or 16)
@@ -501,6 +646,18 @@ void lexScanNumber(char *srcp) {
             isFloat = '.';
             continue;
         }
+#ifdef LEX_SWAR_DIGITS
+        // Consume decimal digits 8 at a time, when available
+        if (base == 10 && lex->srcend - srcp >= 8) {
+            uint64_t chunk;
+            memcpy(&chunk, srcp, sizeof(chunk));
+            if (lexIsEightDigits(chunk)) {
+                intval = intval * 100000000 + lexEightDigitsValue(chunk);
+                srcp += 8;
+                continue;
+            }
+        }
+#endif
         // Extract a number digit value from the character
         if (*srcp>='0' && *srcp<='9')
             intval = intval*base + *srcp++ - '0';
@@ -575,7 +732,7 @@ void lexScanNumber(char *srcp) {
 }
 
 /** Tokenize an identifier or reserved token */
-void lexScanIdent(char *srcp) {
+void lexScanIdent(Lexer *lex, char *srcp) {
     char *srcbeg = srcp;    // Pointer to the start of the token
     lex->tokp = srcbeg;
     srcp += utf8ByteSkip(srcp);  // Skip past already accepted first character
@@ -628,7 +785,7 @@ void lexScanIdent(char *srcp) {
 }
 
 /** Tokenize an identifier or reserved token */
-void lexScanTickedIdent(char *srcp) {
+void lexScanTickedIdent(Lexer *lex, char *srcp) {
     char *srcbeg = srcp++;    // Pointer to the start of the token
     lex->tokp = srcbeg;
 
@@ -636,7 +793,7 @@ void lexScanTickedIdent(char *srcp) {
     while (*srcp != '`' && *srcp && *srcp != '\n' && *srcp != '\x1a')
         srcp++;
     if (*srcp != '`') {
-        errorMsgLex(ErrorBadTok, "Back-ticked identifier requires closing backtick");
+        errorMsgLexer(lex, ErrorBadTok, "Back-ticked identifier requires closing backtick");
         srcp = srcbeg + 2;
     }
 
@@ -647,7 +804,7 @@ void lexScanTickedIdent(char *srcp) {
 }
 
 // Skip over nested block comment
-char *lexBlockComment(char *srcp) {
+char *lexBlockComment(Lexer *lex, char *srcp) {
     int nest = 1;
     while (*srcp) {
         if (*srcp == '*' && *(srcp + 1) == '/') {
@@ -687,7 +844,7 @@ char *lexBlockComment(char *srcp) {
 }
 
 // Decode next token from the source into new lex->token
-void lexNextTokenx() {
+void lexNextTokenx(Lexer *lex) {
     char *srcp;
     srcp = lex->srcp;
     ++lex->tokPosInLine;
@@ -697,12 +854,12 @@ void lexNextTokenx() {
         // Numeric literal (integer or float)
         case '0': case '1': case '2': case '3': case '4':
         case '5': case '6': case '7': case '8': case '9':
-            lexScanNumber(srcp);
+            lexScanNumber(lex, srcp);
             return;
 
         // ' ' - single character surrounded with single quotes
         case '\'':
-            lexScanChar(srcp);
+            lexScanChar(lex, srcp);
             return;
 
         // " " - string surrounded with double quotes
@@ -710,7 +867,7 @@ void lexNextTokenx() {
             if (lex->strexpr != StrExprOff) {
                 lexReturnPuncTok(RStrExprToken, 1);
             }
-            lexScanString(srcp);
+            lexScanString(lex, srcp);
             return;
 
         // StringExpr
@@ -732,12 +889,12 @@ void lexNextTokenx() {
         case 'P': case 'Q': case 'R': case 'S': case 'T':
         case 'U': case 'V': case 'W': case 'X': case 'Y': case 'Z':
         case '#': case '@': case '_':
-            lexScanIdent(srcp);
+            lexScanIdent(lex, srcp);
             return;
 
         // backtick enclosed identifiers
         case '`':
-            lexScanTickedIdent(srcp);
+            lexScanTickedIdent(lex, srcp);
             return;
 
         case '.': lexReturnPuncTok(DotToken, 1);
@@ -924,7 +1081,7 @@ void lexNextTokenx() {
             }
             // Block comment, nested: '/*'
             else if (*(srcp + 1) == '*') {
-                srcp = lexBlockComment(srcp+2);
+                srcp = lexBlockComment(lex, srcp+2);
             }
             // '/' operator (e.g., division)
             else if (*(srcp + 1) == '=') {
@@ -946,7 +1103,7 @@ void lexNextTokenx() {
 
         // Handle new line
         case '\n':
-            srcp = lexNewLine(srcp);
+            srcp = lexNewLine(lex, srcp);
             break;
 
         // End-of-file
@@ -958,12 +1115,12 @@ void lexNextTokenx() {
             {
                 if (utf8IsLetter(srcp)) {
                     // Treat unicode character as the start of an identifier
-                    lexScanIdent(srcp);
+                    lexScanIdent(lex, srcp);
                     return;
                 }
                 else {
                     lex->tokp = srcp;
-                    errorMsgLex(ErrorBadTok, "Bad character '%c' starting unknown token", *srcp);
+                    errorMsgLexer(lex, ErrorBadTok, "Bad character '%c' starting unknown token", *srcp);
                     srcp += utf8ByteSkip(srcp);
                 }
             }
@@ -971,9 +1128,149 @@ void lexNextTokenx() {
     }
 }
 
+// ******  PRE-LEXED TOKEN BUFFER **********
+
+// Grow a token buffer array (by doubling), copying over old contents
+static void *lexGrowArray(void *oldarray, uint32_t oldsize, uint32_t newsize, size_t eltsize) {
+    void *newarray = memAllocBlk(newsize * eltsize);
+    if (oldsize)
+        memcpy(newarray, oldarray, oldsize * eltsize);
+    return newarray;
+}
+
+// Append lexer's current token to its token buffer
+static void lexerRecordToken(Lexer *lex, LexTokenBuf *buf) {
+    // A new line entry is needed for each line's first token
+    if (buf->nlines == 0 || lex->tokPosInLine == 0) {
+        if (buf->nlines >= buf->linealloc) {
+            uint32_t newsize = buf->linealloc << 1;
+            buf->lineindents = (int16_t*)lexGrowArray(buf->lineindents, buf->nlines, newsize, sizeof(int16_t));
+            buf->linealloc = newsize;
+        }
+        buf->lineindents[buf->nlines] = lex->curindent;
+        ++buf->nlines;
+    }
+
+    // Most tokens (punctuation, keywords) leave value info unchanged, so share the last entry
+    LexTokenVal *lastval = buf->nvals ? &buf->vals[buf->nvals - 1] : NULL;
+    if (lastval == NULL || memcmp(&lastval->val, &lex->val, sizeof(LexVal)) != 0
+        || lastval->strlen != lex->strlen || lastval->langtype != lex->langtype) {
+        if (buf->nvals >= buf->valalloc) {
+            uint32_t newsize = buf->valalloc << 1;
+            buf->vals = (LexTokenVal*)lexGrowArray(buf->vals, buf->nvals, newsize, sizeof(LexTokenVal));
+            buf->valalloc = newsize;
+        }
+        LexTokenVal *newval = &buf->vals[buf->nvals++];
+        newval->val = lex->val;
+        newval->strlen = lex->strlen;
+        newval->langtype = lex->langtype;
+    }
+
+    if (buf->ntokens >= buf->tokalloc) {
+        uint32_t newsize = buf->tokalloc << 1;
+        buf->toktypes = (uint16_t*)lexGrowArray(buf->toktypes, buf->ntokens, newsize, sizeof(uint16_t));
+        buf->tokoffs = (uint32_t*)lexGrowArray(buf->tokoffs, buf->ntokens, newsize, sizeof(uint32_t));
+        buf->toklines = (uint32_t*)lexGrowArray(buf->toklines, buf->ntokens, newsize, sizeof(uint32_t));
+        buf->tokvals = (uint32_t*)lexGrowArray(buf->tokvals, buf->ntokens, newsize, sizeof(uint32_t));
+        buf->tokalloc = newsize;
+    }
+    uint32_t tok = buf->ntokens++;
+    buf->toktypes[tok] = lex->toktype | (lex->tokPosInLine == 0 ? LexTokFirstInLine : 0);
+    buf->tokoffs[tok] = (uint32_t)(lex->tokp - lex->source);
+    buf->toklines[tok] = buf->nlines - 1;
+    buf->tokvals[tok] = buf->nvals - 1;
+}
+
+// Make a pre-lexed token the lexer's current token
+static void lexerLoadToken(Lexer *lex, uint32_t pos) {
+    LexTokenBuf *buf = lex->tokbuf;
+    buf->pos = pos;
+    uint16_t toktype = buf->toktypes[pos];
+    lex->toktype = toktype & ~LexTokFirstInLine;
+    lex->tokPosInLine = (toktype & LexTokFirstInLine) ? 0 : 1;
+    lex->tokp = lex->source + buf->tokoffs[pos];
+    lex->curindent = buf->lineindents[buf->toklines[pos]];
+    LexTokenVal *val = &buf->vals[buf->tokvals[pos]];
+    lex->val = val->val;
+    lex->strlen = val->strlen;
+    lex->langtype = val->langtype;
+}
+
 // Obtain next token (and time how long it takes)
-void lexNextToken() {
+void lexerNextToken(Lexer *lex) {
+    if (lex->tokbuf) {
+        // Pre-lexed: stay on the final EofToken once we reach it
+        if (lex->tokbuf->pos + 1 < lex->tokbuf->ntokens)
+            lexerLoadToken(lex, lex->tokbuf->pos + 1);
+        return;
+    }
     timerBegin(LexTimer);
-    lexNextTokenx();
+    lexNextTokenx(lex);
     timerBegin(ParseTimer);
 }
+
+// Lex all of a lexer's remaining source into a token buffer, then consume from it.
+// Lexing never depends on parser state, so this yields the same token stream
+// (and lexer state per token) as lexing on demand.
+void lexerPrelex(Lexer *lex) {
+    if (lex->tokbuf)
+        return;
+    timerBegin(LexTimer);
+    LexTokenBuf *buf = (LexTokenBuf*)memAllocBlk(sizeof(LexTokenBuf));
+    memset(buf, 0, sizeof(LexTokenBuf));
+    // Initial sizes are a rough guess from source size
+    size_t srcsize = strlen(lex->srcp);
+    buf->tokalloc = (uint32_t)(srcsize >> 2) + 16;
+    buf->linealloc = lex->nlines + 1;
+    buf->valalloc = (uint32_t)(srcsize >> 3) + 16;
+    buf->toktypes = (uint16_t*)memAllocBlk(buf->tokalloc * sizeof(uint16_t));
+    buf->tokoffs = (uint32_t*)memAllocBlk(buf->tokalloc * sizeof(uint32_t));
+    buf->toklines = (uint32_t*)memAllocBlk(buf->tokalloc * sizeof(uint32_t));
+    buf->tokvals = (uint32_t*)memAllocBlk(buf->tokalloc * sizeof(uint32_t));
+    buf->lineindents = (int16_t*)memAllocBlk(buf->linealloc * sizeof(int16_t));
+    buf->vals = (LexTokenVal*)memAllocBlk(buf->valalloc * sizeof(LexTokenVal));
+
+    // The current token has already been lexed; record it and all that follow
+    while (1) {
+        lexerRecordToken(lex, buf);
+        if (lex->toktype == EofToken)
+            break;
+        lexNextTokenx(lex);
+    }
+    lex->tokbuf = buf;
+    lexerLoadToken(lex, 0);
+    timerBegin(ParseTimer);
+}
+
+// Return the type of the token n tokens past the current one (0 = current token)
+uint16_t lexerPeekToken(Lexer *lex, uint32_t n) {
+    if (n == 0)
+        return lex->toktype;
+    LexTokenBuf *buf = lex->tokbuf;
+    if (buf == NULL)
+        return NbrTokens;
+    uint32_t pos = buf->pos + n;
+    if (pos >= buf->ntokens)
+        return EofToken;
+    return buf->toktypes[pos] & ~LexTokFirstInLine;
+}
+
+// Is the token after the current one of this type?
+int lexerNextIsToken(Lexer *lex, uint16_t toktype) {
+    if (lex->tokbuf)
+        return lexerPeekToken(lex, 1) == toktype;
+
+    // Look at the next source character past any white space
+    char ch;
+    switch (toktype) {
+    case CommaToken: ch = ','; break;
+    case SemiToken: ch = ';'; break;
+    case RParenToken: ch = ')'; break;
+    case RBracketToken: ch = ']'; break;
+    default: return 0;
+    }
+    char *srcp = lex->srcp;
+    while (*srcp == ' ' || *srcp == '\t' || *srcp == '\r' || *srcp == '\n')
+        ++srcp;
+    return *srcp == ch;
+}
@@ -14,7 +14,7 @@ typedef struct Name Name;    // ../ast/nametbl.h
 #include "../coneopts.h"
 #include <stdint.h>
 
-#define LEX_MAX_BLOCKS 1024
+#define LEX_MAX_BLOCKS 1024    // Block stack grows as needed, up to this limit
 
 // What sort of block the lexer is working with
 typedef enum {
@@ -36,15 +36,51 @@ typedef struct {
     LexBlockMode blkmode;     // Lexer block mode
 } LexBlockInfo;
 
+// Value info about a discovered token
+typedef union LexVal {
+    double floatlit;
+    uint64_t uintlit;
+    char *strlit;
+    Name *ident;
+} LexVal;
+
+// A pre-lexed token's value info (shared by consecutive tokens that leave it unchanged)
+typedef struct LexTokenVal {
+    LexVal val;
+    uint32_t strlen;
+    INode *langtype;
+} LexTokenVal;
+
+// Flag on a pre-lexed token's type: it is the first token on its line
+#define LexTokFirstInLine 0x8000
+
+// Pre-lexed token buffer holding all of a source's tokens, as a structure of arrays.
+// Tokens refer to a line table (for indentation) and to a table of value info
+// (for literals and identifiers). Token positions are recovered via the source's line index.
+typedef struct LexTokenBuf {
+    uint16_t *toktypes;      // Token type (with LexTokFirstInLine flag)
+    uint32_t *tokoffs;       // Offset of token's start in source
+    uint32_t *toklines;      // Index of token's line in line table
+    uint32_t *tokvals;       // Index of token's value info in vals
+    uint32_t ntokens;
+    uint32_t tokalloc;
+
+    int16_t *lineindents;    // Line's indentation
+    uint32_t nlines;
+    uint32_t linealloc;
+
+    LexTokenVal *vals;       // Value info
+    uint32_t nvals;
+    uint32_t valalloc;
+
+    uint32_t pos;            // Index of current token
+} LexTokenBuf;
+
 // Lexer state (one per source file)
+// All lexing functions take an explicit lexer, so several lexers may be active at once.
 typedef struct Lexer {
     // Value info about a discovered token
-    union {
-        double floatlit;
-        uint64_t uintlit;
-        char *strlit;
-        Name *ident;
-    } val;
+    LexVal val;
     uint32_t strlen;   // Size of string literal
     INode *langtype;
 
@@ -52,16 +88,14 @@ typedef struct Lexer {
     char *url;        // The url where the source text came from
     char *fname;    // The filename of the url (no extension)
     char *source;    // The source text (0-terminated)
-
-    struct Lexer *next;    // Next lexer (linked list of injected lexers)
-    struct Lexer *prev; // Previous lexer
+    char *srcend;    // End of source text (its terminating 0)
+    uint32_t *linestarts;   // Line index: source offset of every line's start
+    uint32_t nlines;        // Number of lines in line index
 
     // Lexer's evolving state
     char *srcp;        // Current pointer
     char *tokp;        // Start of current token
-    char *linep;    // Pointer to start of current line
 
-    uint32_t linenbr;    // Current line number
     uint32_t flags;        // Lexer flags
     uint16_t toktype;    // TokenTypes
 
@@ -73,7 +107,10 @@ typedef struct Lexer {
     int16_t tokPosInLine;    // 0=First token in line, 1=Second, etc.
     char indentch;           // Are we using spaces or tabs?
     int16_t blkStackLvl;     // How deep are we into block stack
-    LexBlockInfo blkStack[LEX_MAX_BLOCKS];  // Block stack
+    int16_t blkStackSz;      // Allocated size of block stack
+    LexBlockInfo *blkStack;  // Block stack (grows as needed)
+
+    LexTokenBuf *tokbuf;     // Pre-lexed tokens (or NULL when lexing on demand)
 } Lexer;
 
 // All the possible types for a token
@@ -190,39 +227,53 @@ enum TokenTypes {
     NbrTokens
 };
 
-// Current lexer
-extern Lexer *lex;
-
-#define lexIsToken(tok) (lex->toktype == (tok))
+// Is the lexer's current token of this type?
+#define lexerIsToken(lex, tok) ((lex)->toktype == (tok))
 
 // Lexer functions
 void lexInit(ConeOptions *opt);
-void lexInjectFile(char *url);
-void lexInject(char *src, char *url);
-void lexPop();
-void lexNextToken();
+
+// Create a new lexer for a source stream
+Lexer *newLexer(char *src, char *url);
+// Create a new lexer for a source file, found relative to the source of lexer from (if not NULL)
+Lexer *newLexerFile(Lexer *from, char *url);
+// Initialize a lexer to start lexing a source stream
+void lexerInit(Lexer *lex, char *src, char *url);
+// Return the line number (starting with 1) containing source offset,
+// found by binary search of the line index. Also return start of line in *linep.
+uint32_t lexerLineOf(Lexer *lex, uint32_t srcoff, char **linep);
+// Obtain next token
+void lexerNextToken(Lexer *lex);
+// Lex all of a lexer's remaining source into a token buffer, then consume from it
+void lexerPrelex(Lexer *lex);
+// Return the type of the token n tokens past the current one (0 = current token).
+// Lookahead past the current token requires a pre-lexed lexer; otherwise returns NbrTokens.
+uint16_t lexerPeekToken(Lexer *lex, uint32_t n);
+// Is the token after the current one of this type? Without pre-lexing, this only
+// recognizes the ',', ';', ')' and ']' tokens, and returns 0 when unsure.
+int lexerNextIsToken(Lexer *lex, uint16_t toktype);
 
 // Parser indicates new block starts here, e.g., '{'
-void lexBlockStart(LexBlockMode mode);
+void lexerBlockStart(Lexer *lex, LexBlockMode mode);
 // Does block end here, based on block mode?
-int lexIsBlockEnd();
+int lexerIsBlockEnd(Lexer *lex);
 // Parser indicates block finishes here, e.g., '}'
-void lexBlockEnd();
+void lexerBlockEnd(Lexer *lex);
 
 // Decrement counter for parentheses/brackets
-void lexDecrParens();
+void lexerDecrParens(Lexer *lex);
 // Increment counter for parentheses/brackets
-void lexIncrParens();
+void lexerIncrParens(Lexer *lex);
 
 // Is next token at start of line?
-int lexIsEndOfLine();
+int lexerIsEndOfLine(Lexer *lex);
 
 // Parser signals the start of a new statement (for continuation analysis)
-void lexStmtStart();
+void lexerStmtStart(Lexer *lex);
 
 // Return true if current token is first on a line that has not been indented
 // This is used by parser to determine whether an operator that starts a new line
 // should be treated as a continuation (infix) or a new statement (prefix).
-int lexIsStmtBreak();
+int lexerIsStmtBreak(Lexer *lex);
 
 #endif
@@ -15,27 +15,28 @@
 #include "lexer.h"
 
 #include <stdio.h>
+#include <string.h>
 #include <assert.h>
 
 // Parse a name use, which may be qualified with module names
 INode *parseNameUse(ParseState *parse) {
-    NameUseNode *nameuse = newNameUseNode(NULL);
+    NameUseNode *nameuse = parsePos(parse, newNameUseNode(NULL));
 
     int baseset = 0;
-    if (lexIsToken(DblColonToken)) {
+    if (lexerIsToken(parse->lex, DblColonToken)) {
         nameUseBaseMod(nameuse, parse->pgmmod);
         baseset = 1;
     }
     while (1) {
-        if (lexIsToken(IdentToken)) {
-            Name *name = lex->val.ident;
-            lexNextToken();
+        if (lexerIsToken(parse->lex, IdentToken)) {
+            Name *name = parse->lex->val.ident;
+            lexerNextToken(parse->lex);
             // Identifier is a module qualifier
-            if (lexIsToken(DblColonToken)) {
+            if (lexerIsToken(parse->lex, DblColonToken)) {
                 if (!baseset)
                     nameUseBaseMod(nameuse, parse->mod); // relative to current module
                 nameUseAddQual(nameuse, name);
-                lexNextToken();
+                lexerNextToken(parse->lex);
             }
             // Identifier is the actual name itself
             else {
@@ -45,87 +46,121 @@ INode *parseNameUse(ParseState *parse) {
         }
         // Can only get here if previous token was double quotes
         else {
-            errorMsgLex(ErrorNoVar, "Missing variable name after module qualifiers");
+            errorMsgLexer(parse->lex, ErrorNoVar, "Missing variable name after module qualifiers");
             break;
         }
     }
     return (INode*)nameuse;
 }
 
+// Pack a numeric literal array element into the array's typed value buffer,
+// rather than parse it into a literal node. Returns 0 if it cannot be packed.
+int parseArrayLitPack(ParseState *parse, ArrayNode *array) {
+    uint16_t littag;
+    if (lexerIsToken(parse->lex, IntLitToken))
+        littag = ULitTag;
+    else if (lexerIsToken(parse->lex, FloatLitToken))
+        littag = FLitTag;
+    else
+        return 0;
+
+    // Literal must be the whole element, with all elements of the same kind and type
+    if (!arrayLitPackable(array, littag, parse->lex->langtype)
+        || !(lexerNextIsToken(parse->lex, CommaToken) || lexerNextIsToken(parse->lex, RBracketToken)))
+        return 0;
+
+    uint64_t bits;
+    if (littag == ULitTag)
+        bits = parse->lex->val.uintlit;
+    else
+        memcpy(&bits, &parse->lex->val.floatlit, sizeof(bits));
+    arrayLitPackAdd(array, littag, parse->lex->langtype, bits, (uint32_t)(parse->lex->tokp - parse->lex->source));
+    lexerNextToken(parse->lex);
+    return 1;
+}
+
 // Parse an array literal
 INode *parseArrayLit(ParseState *parse, INode *typenode) {
-    ArrayNode *array = newArrayNode();
-    lexNextToken();
+    ArrayNode *array = parsePos(parse, newArrayNode());
+    lexerNextToken(parse->lex);
 
     // Gather comma-separated expressions that are likely elements or element type
     while (1) {
-        nodesAdd(&array->elems, parseSimpleExpr(parse));
-        if (!lexIsToken(CommaToken))
+        if (!parseArrayLitPack(parse, array)) {
+            arrayLitUnpack(array);
+            nodesAdd(&array->elems, parseSimpleExpr(parse));
+        }
+        if (!lexerIsToken(parse->lex, CommaToken))
             break;
-        lexNextToken();
+        lexerNextToken(parse->lex);
     }
 
     // Semi-colon signals we had dimensions instead, swap and then get elements
-    if (lexIsToken(SemiToken)) {
-        lexNextToken();
+    if (lexerIsToken(parse->lex, SemiToken)) {
+        arrayLitUnpack(array);
+        lexerNextToken(parse->lex);
         Nodes *elems = array->dimens;
         array->dimens = array->elems;
         while (1) {
             nodesAdd(&elems, parseSimpleExpr(parse));
-            if (!lexIsToken(CommaToken))
+            if (!lexerIsToken(parse->lex, CommaToken))
                 break;
-            lexNextToken();
+            lexerNextToken(parse->lex);
         };
         array->elems = elems;
     }
-    parseCloseTok(RBracketToken);
+    parseCloseTok(parse, RBracketToken);
+
+    // Only long lists of literals are worth keeping packed
+    if (array->packed && array->packed->used < ArrayLitPackMin)
+        arrayLitUnpack(array);
 
     return (INode *)array;
 }
 
 // Parse a term: literal, identifier, etc.
 INode *parseTerm(ParseState *parse) {
-    switch (lex->toktype) {
+    switch (parse->lex->toktype) {
     case nilToken:
     {
-        NilLitNode *node = newNilLitNode();
-        lexNextToken();
+        NilLitNode *node = parsePos(parse, newNilLitNode());
+        lexerNextToken(parse->lex);
         return (INode *)node;
     }
     case trueToken:
     {
-        ULitNode *node = newULitNode(1, (INode*)boolType);
-        lexNextToken();
+        ULitNode *node = parsePos(parse, newULitNode(1, (INode*)boolType));
+        lexerNextToken(parse->lex);
         return (INode *)node;
     }
     case falseToken:
     {
-        ULitNode *node = newULitNode(0, (INode*)boolType);
-        lexNextToken();
+        ULitNode *node = parsePos(parse, newULitNode(0, (INode*)boolType));
+        lexerNextToken(parse->lex);
         return (INode *)node;
     }
     case VoidToken:
     {
-        VoidTypeNode *voidnode = newVoidNode();
-        lexNextToken();
+        VoidTypeNode *voidnode = parsePos(parse, newVoidNode());
+        lexerNextToken(parse->lex);
         return (INode *)voidnode;
     }
     case IntLitToken:
         {
-            ULitNode *node = newULitNode(lex->val.uintlit, lex->langtype);
-            lexNextToken();
+            ULitNode *node = parsePos(parse, newULitNode(parse->lex->val.uintlit, parse->lex->langtype));
+            lexerNextToken(parse->lex);
             return (INode *)node;
         }
     case FloatLitToken:
         {
-            FLitNode *node = newFLitNode(lex->val.floatlit, lex->langtype);
-            lexNextToken();
+            FLitNode *node = parsePos(parse, newFLitNode(parse->lex->val.floatlit, parse->lex->langtype));
+            lexerNextToken(parse->lex);
             return (INode *)node;
         }
     case StringLitToken:
         {
-            SLitNode *node = newSLitNode(lex->val.strlit, lex->strlen);
-            lexNextToken();
+            SLitNode *node = parsePos(parse, newSLitNode(parse->lex->val.strlit, parse->lex->strlen));
+            lexerNextToken(parse->lex);
             return (INode *)node;
         }
     case IdentToken:
@@ -134,10 +169,10 @@ INode *parseTerm(ParseState *parse) {
     case LParenToken:
         {
             INode *node;
-            lexNextToken();
-            lexIncrParens();
+            lexerNextToken(parse->lex);
+            lexerIncrParens(parse->lex);
             node = parseAnyExpr(parse);
-            parseCloseTok(RParenToken);
+            parseCloseTok(parse, RParenToken);
             return node;
         }
     case LBracketToken:
@@ -153,8 +188,8 @@ INode *parseTerm(ParseState *parse) {
     case LCurlyToken:
         return parseExprBlock(parse, 0);
     default:
-        errorMsgLex(ErrorBadTerm, "Invalid term: expected name, literal, etc.");
-        lexNextToken(); // Avoid infinite loop
+        errorMsgLexer(parse->lex, ErrorBadTerm, "Invalid term: expected name, literal, etc.");
+        lexerNextToken(parse->lex); // Avoid infinite loop
         return NULL;
     }
 }
@@ -162,11 +197,11 @@ INode *parseTerm(ParseState *parse) {
 // Parse a function/method call argument
 INode *parseArg(ParseState *parse) {
     INode *arg = parseSimpleExpr(parse);
-    if (lexIsToken(ColonToken)) {
+    if (lexerIsToken(parse->lex, ColonToken)) {
         if (arg->tag != NameUseTag)
             errorMsgNode((INode*)arg, ErrorNoName, "Expected a named identifier");
-        arg = (INode*)newNamedValNode(arg);
-        lexNextToken();
+        arg = (INode*)parsePos(parse, newNamedValNode(arg));
+        lexerNextToken(parse->lex);
         ((NamedValNode *)arg)->val = parseSimpleExpr(parse);
     }
     return arg;
@@ -174,39 +209,39 @@ INode *parseArg(ParseState *parse) {
 
 // Parse multiple arguments inside () or []. Return a Nodes containing all argument nodes.
 Nodes *parseArgs(ParseState *parse) {
-    int closetok = lex->toktype == LBracketToken ? RBracketToken : RParenToken;
-    lexNextToken();
-    lexIncrParens();
+    int closetok = parse->lex->toktype == LBracketToken ? RBracketToken : RParenToken;
+    lexerNextToken(parse->lex);
+    lexerIncrParens(parse->lex);
     Nodes *args = newNodes(8);
-    if (!lexIsToken(closetok)) {
+    if (!lexerIsToken(parse->lex, closetok)) {
         nodesAdd(&args, parseArg(parse));
-        while (lexIsToken(CommaToken)) {
-            lexNextToken();
+        while (lexerIsToken(parse->lex, CommaToken)) {
+            lexerNextToken(parse->lex);
             nodesAdd(&args, parseArg(parse));
         }
     }
-    parseCloseTok(closetok);
+    parseCloseTok(parse, closetok);
     return args;
 }
 
 // Parse a '.'-based method call/field access
 INode *parseDotCall(ParseState *parse, INode *node, uint16_t flags) {
-    FnCallNode *fncall = newFnCallNode(node, 0);
+    FnCallNode *fncall = parsePos(parse, newFnCallNode(node, 0));
     fncall->flags |= flags;
-    lexNextToken();
+    lexerNextToken(parse->lex);
 
     // Get field/method name
-    if (lexIsToken(IdentToken)) {
-        NameUseNode *method = newNameUseNode(lex->val.ident);
+    if (lexerIsToken(parse->lex, IdentToken)) {
+        NameUseNode *method = parsePos(parse, newNameUseNode(parse->lex->val.ident));
         method->tag = MbrNameUseTag;
         fncall->methfld = method;
     }
     else
-        errorMsgLex(ErrorNoMbr, "This should be a named field/method");
-    lexNextToken();
+        errorMsgLexer(parse->lex, ErrorNoMbr, "This should be a named field/method");
+    lexerNextToken(parse->lex);
 
     // Parentheses after '.' are part of same fncall operation
-    if (lexIsToken(LParenToken))
+    if (lexerIsToken(parse->lex, LParenToken))
         fncall->args = parseArgs(parse);
     return (INode*)fncall;
 }
@@ -217,38 +252,38 @@ INode *parseSuffix(ParseState *parse, INode *node, uint16_t flags) {
 
     // Process as many suffixes as we have, each applying to the term before
     while (1) {
-        if (lexIsToken(DotToken) && !lexIsStmtBreak()) {
+        if (lexerIsToken(parse->lex, DotToken) && !lexerIsStmtBreak(parse->lex)) {
             node = parseDotCall(parse, node, flags);
         }
 
         // Handle () suffix and enclosed arguments
-        else if (lexIsToken(LParenToken) && !lexIsStmtBreak()) {
-            FnCallNode *fncall = newFnCallNode(node, 0);
+        else if (lexerIsToken(parse->lex, LParenToken) && !lexerIsStmtBreak(parse->lex)) {
+            FnCallNode *fncall = parsePos(parse, newFnCallNode(node, 0));
             fncall->flags |= flags;
             fncall->args = parseArgs(parse);
             node = (INode*)fncall;
         }
 
         // Handle [] indexing suffix and enclosed arguments
-        else if (lexIsToken(LBracketToken) && !lexIsStmtBreak()) {
-            FnCallNode *fncall = newFnCallNode(node, 0);
+        else if (lexerIsToken(parse->lex, LBracketToken) && !lexerIsStmtBreak(parse->lex)) {
+            FnCallNode *fncall = parsePos(parse, newFnCallNode(node, 0));
             fncall->flags |= flags | FlagIndex;
             fncall->args = parseArgs(parse);
             node = (INode*)fncall;
         }
 
         // Handle postfix ++
-        else if (lexIsToken(IncrToken) && !lexIsStmtBreak()) {
-            node = (INode*)newFnCallOpname(node, incrPostName, 0);
+        else if (lexerIsToken(parse->lex, IncrToken) && !lexerIsStmtBreak(parse->lex)) {
+            node = (INode*)parsePos(parse, newFnCallOpname(node, incrPostName, 0));
             node->flags |= FlagLvalOp;
-            lexNextToken();
+            lexerNextToken(parse->lex);
         }
 
         // Handle postfix --
-        else if (lexIsToken(DecrToken) && !lexIsStmtBreak()) {
-            node = (INode*)newFnCallOpname(node, decrPostName, 0);
+        else if (lexerIsToken(parse->lex, DecrToken) && !lexerIsStmtBreak(parse->lex)) {
+            node = (INode*)parsePos(parse, newFnCallOpname(node, decrPostName, 0));
             node->flags |= FlagLvalOp;
-            lexNextToken();
+            lexerNextToken(parse->lex);
         }
 
         // No suffix, we are done with suffixes
@@ -273,28 +308,28 @@ INode *parsePrefix(ParseState *parse, int noSuffix);
 INode *parseAmper(ParseState *parse) {
     // Create appropriate RefNode, depending on ampersand operator
     RefNode *anode;
-    switch (lex->toktype) {
+    switch (parse->lex->toktype) {
     case AmperToken:
-        anode = newRefNode(RefTag); break;
+        anode = parsePos(parse, newRefNode(RefTag)); break;
     case ArrayRefToken:
-        anode = newRefNode(ArrayRefTag); break;
+        anode = parsePos(parse, newRefNode(ArrayRefTag)); break;
     case VirtRefToken:
-        anode = newRefNode(VirtRefTag); break;
+        anode = parsePos(parse, newRefNode(VirtRefTag)); break;
     }
-    lexNextToken();
+    lexerNextToken(parse->lex);
 
     // Static permission (optional)
-    anode->perm = parsePerm();
+    anode->perm = parsePerm(parse);
 
     // Handle borrowed reference to anonymous function/closure
     // Note: This could also be a ref to a function signature. We sort this out later.
-    if (lexIsToken(FnToken)) {
+    if (lexerIsToken(parse->lex, FnToken)) {
         FnDclNode *fndcl = (FnDclNode*)parseFn(parse, ParseMayAnon | ParseMayImpl | ParseMaySig | ParseEmbedded);
         if (fndcl->value) {
             // If we have an implemented function, we need to move it to the module so it gets generated
             // Then refer to it using a nameuse node as part of this reference node
             nodesAdd(&parse->mod->nodes, (INode*)fndcl);
-            NameUseNode *fnname = newNameUseNode(anonName);
+            NameUseNode *fnname = parsePos(parse, newNameUseNode(anonName));
             fnname->tag = VarNameUseTag;
             fnname->dclnode = (INode*)fndcl;
             fnname->vtype = fndcl->vtype;
@@ -309,7 +344,7 @@ INode *parseAmper(ParseState *parse) {
 
     // For a function parameter type, we allow incomplete reference types
     // where the type the reference points-to can be inferred later (typically, Self)
-    if (lexIsToken(CommaToken) || lexIsToken(RParenToken)) {
+    if (lexerIsToken(parse->lex, CommaToken) || lexerIsToken(parse->lex, RParenToken)) {
         anode->vtexp = unknownType;
         return (INode *)anode;
     }
@@ -329,40 +364,40 @@ INode *parseAmper(ParseState *parse) {
 INode *parsePlus(ParseState *parse) {
     // Create appropriate RefNode, depending on ampersand operator
     RefNode *anode;
-    switch (lex->toktype) {
+    switch (parse->lex->toktype) {
     case PlusToken:
-        anode = newRefNode(RefTag); break;
+        anode = parsePos(parse, newRefNode(RefTag)); break;
     case PlusArrayRefToken:
-        anode = newRefNode(ArrayRefTag); break;
+        anode = parsePos(parse, newRefNode(ArrayRefTag)); break;
     case PlusVirtRefToken:
-        anode = newRefNode(VirtRefTag); break;
+        anode = parsePos(parse, newRefNode(VirtRefTag)); break;
     }
-    lexNextToken();
+    lexerNextToken(parse->lex);
 
     // Region-managed reference starts with a region annotation
-    if (!lexIsToken(IdentToken)) {
-        errorMsgLex(ErrorBadTerm, "Expected region annotation.");
+    if (!lexerIsToken(parse->lex, IdentToken)) {
+        errorMsgLexer(parse->lex, ErrorBadTerm, "Expected region annotation.");
         return (INode *)anode;
     }
     anode->region = parseNameUse(parse);
 
     // Handle permission, if specified
-    if (lexIsToken(DashToken)) {
-        lexNextToken();
-        if (lexIsToken(PermToken)) {
-            anode->perm = newPermUseNode((PermNode*)lex->val.ident->node);
-            lexNextToken();
+    if (lexerIsToken(parse->lex, DashToken)) {
+        lexerNextToken(parse->lex);
+        if (lexerIsToken(parse->lex, PermToken)) {
+            anode->perm = parsePos(parse, newPermUseNode((PermNode*)parse->lex->val.ident->node));
+            lexerNextToken(parse->lex);
         }
-        else if (lexIsToken(IdentToken)) {
+        else if (lexerIsToken(parse->lex, IdentToken)) {
             anode->perm = parseNameUse(parse);
         }
         else {
-            errorMsgLex(ErrorBadTerm, "Expected permission annotation.");
+            errorMsgLexer(parse->lex, ErrorBadTerm, "Expected permission annotation.");
             return (INode *)anode;
         }
     }
     else
-        anode->perm = newPermUseNode(uniPerm);
+        anode->perm = parsePos(parse, newPermUseNode(uniPerm));
 
     // Handle type or value expression
     anode->vtexp = parsePrefix(parse, 0);
@@ -372,20 +407,20 @@ INode *parsePlus(ParseState *parse) {
 // Parse a prefix operator.
 // If noSuffix flag on (for borrowed refs), parse only a term next, otherwise parse term+suffix.
 INode *parsePrefix(ParseState *parse, int noSuffix) {
-    switch (lex->toktype) {
+    switch (parse->lex->toktype) {
 
     // '.' sugar for: this.suffixes
     case DotToken:
     {
-        INode *node = parseDotCall(parse, (INode*)newNameUseNode(thisName), 0);
+        INode *node = parseDotCall(parse, (INode*)parsePos(parse, newNameUseNode(thisName)), 0);
         return parseSuffix(parse, node, 0);
     }
 
     // '*' (dereference or pointer type)
     case StarToken:
     {
-        StarNode *node = newStarNode(StarTag);
-        lexNextToken();
+        StarNode *node = parsePos(parse, newStarNode(StarTag));
+        lexerNextToken(parse->lex);
         node->vtexp = parsePrefix(parse, noSuffix);
         return (INode *)node;
     }
@@ -406,10 +441,10 @@ INode *parsePrefix(ParseState *parse, int noSuffix) {
     case QuesToken:
     {
         // Lower into 'Option[expr]'
-        NameUseNode *option = newNameUseNode(optionName);
-        FnCallNode *opttype = newFnCallNode((INode*)option, 1);
+        NameUseNode *option = parsePos(parse, newNameUseNode(optionName));
+        FnCallNode *opttype = parsePos(parse, newFnCallNode((INode*)option, 1));
         opttype->tag = QuesTag;  // In name resolution pass, we will lower to FnCallTag or AllocTag
-        lexNextToken();
+        lexerNextToken(parse->lex);
         nodesAdd(&opttype->args, parsePrefix(parse, noSuffix));
         return (INode*)opttype;
     }
@@ -417,8 +452,8 @@ INode *parsePrefix(ParseState *parse, int noSuffix) {
     // '-' (negative). Optimize for literals
     case DashToken:
     {
-        FnCallNode *node = newFnCallOpname(NULL, minusName, 0);
-        lexNextToken();
+        FnCallNode *node = parsePos(parse, newFnCallOpname(NULL, minusName, 0));
+        lexerNextToken(parse->lex);
         INode *argnode = parsePrefix(parse, noSuffix);
         if (argnode->tag == ULitTag) {
             ((ULitNode*)argnode)->uintlit = (uint64_t)-((int64_t)((ULitNode*)argnode)->uintlit);
@@ -435,8 +470,8 @@ INode *parsePrefix(ParseState *parse, int noSuffix) {
     // '~' (bitwise not)
     case TildeToken:
     {
-        FnCallNode *node = newFnCallOp(NULL, "~", 0);
-        lexNextToken();
+        FnCallNode *node = parsePos(parse, newFnCallOp(NULL, "~", 0));
+        lexerNextToken(parse->lex);
         node->objfn = parsePrefix(parse, noSuffix);
         return (INode *)node;
     }
@@ -444,9 +479,9 @@ INode *parsePrefix(ParseState *parse, int noSuffix) {
     // '++' (prefix increment)
     case IncrToken:
     {
-        FnCallNode *node = newFnCallOpname(NULL, incrName, 0);
+        FnCallNode *node = parsePos(parse, newFnCallOpname(NULL, incrName, 0));
         node->flags |= FlagLvalOp;
-        lexNextToken();
+        lexerNextToken(parse->lex);
         node->objfn = parsePrefix(parse, noSuffix);
         return (INode *)node;
     }
@@ -454,9 +489,9 @@ INode *parsePrefix(ParseState *parse, int noSuffix) {
     // '--' (prefix decrement)
     case DecrToken:
     {
-        FnCallNode *node = newFnCallOpname(NULL, decrName, 0);
+        FnCallNode *node = parsePos(parse, newFnCallOpname(NULL, decrName, 0));
         node->flags |= FlagLvalOp;
-        lexNextToken();
+        lexerNextToken(parse->lex);
         node->objfn = parsePrefix(parse, noSuffix);
         return (INode *)node;
     }
@@ -473,15 +508,15 @@ INode *parsePrefix(ParseState *parse, int noSuffix) {
 // Parse type cast
 INode *parseCast(ParseState *parse) {
     INode *lhnode = parsePrefix(parse, 0);
-    if (lexIsToken(AsToken)) {
-        CastNode *node = newRecastNode(lhnode, unknownType);
-        lexNextToken();
+    if (lexerIsToken(parse->lex, AsToken)) {
+        CastNode *node = parsePos(parse, newRecastNode(lhnode, unknownType));
+        lexerNextToken(parse->lex);
         node->typ = parseVtype(parse);
         return (INode*)node;
     }
-    else if (lexIsToken(IntoToken)) {
-        CastNode *node = newConvCastNode(lhnode, unknownType);
-        lexNextToken();
+    else if (lexerIsToken(parse->lex, IntoToken)) {
+        CastNode *node = parsePos(parse, newConvCastNode(lhnode, unknownType));
+        lexerNextToken(parse->lex);
         node->typ = parseVtype(parse);
         return (INode*)node;
     }
@@ -492,21 +527,21 @@ INode *parseCast(ParseState *parse) {
 INode *parseMult(ParseState *parse) {
     INode *lhnode = parseCast(parse);
     while (1) {
-        if (lexIsToken(StarToken) && !lexIsStmtBreak()) {
-            FnCallNode *node = newFnCallOpname(lhnode, multName, 2);
-            lexNextToken();
+        if (lexerIsToken(parse->lex, StarToken) && !lexerIsStmtBreak(parse->lex)) {
+            FnCallNode *node = parsePos(parse, newFnCallOpname(lhnode, multName, 2));
+            lexerNextToken(parse->lex);
             nodesAdd(&node->args, parseCast(parse));
             lhnode = (INode*)node;
         }
-        else if (lexIsToken(SlashToken)) {
-            FnCallNode *node = newFnCallOpname(lhnode, divName, 2);
-            lexNextToken();
+        else if (lexerIsToken(parse->lex, SlashToken)) {
+            FnCallNode *node = parsePos(parse, newFnCallOpname(lhnode, divName, 2));
+            lexerNextToken(parse->lex);
             nodesAdd(&node->args, parseCast(parse));
             lhnode = (INode*)node;
         }
-        else if (lexIsToken(PercentToken)) {
-            FnCallNode *node = newFnCallOpname(lhnode, remName, 2);
-            lexNextToken();
+        else if (lexerIsToken(parse->lex, PercentToken)) {
+            FnCallNode *node = parsePos(parse, newFnCallOpname(lhnode, remName, 2));
+            lexerNextToken(parse->lex);
             nodesAdd(&node->args, parseCast(parse));
             lhnode = (INode*)node;
         }
@@ -519,15 +554,15 @@ INode *parseMult(ParseState *parse) {
 INode *parseAdd(ParseState *parse) {
     INode *lhnode = parseMult(parse);
     while (1) {
-        if (lexIsToken(PlusToken)) {
-            FnCallNode *node = newFnCallOpname(lhnode, plusName, 2);
-            lexNextToken();
+        if (lexerIsToken(parse->lex, PlusToken)) {
+            FnCallNode *node = parsePos(parse, newFnCallOpname(lhnode, plusName, 2));
+            lexerNextToken(parse->lex);
             nodesAdd(&node->args, parseMult(parse));
             lhnode = (INode*)node;
         }
-        else if (lexIsToken(DashToken) && !lexIsStmtBreak()) {
-            FnCallNode *node = newFnCallOpname(lhnode, minusName, 2);
-            lexNextToken();
+        else if (lexerIsToken(parse->lex, DashToken) && !lexerIsStmtBreak(parse->lex)) {
+            FnCallNode *node = parsePos(parse, newFnCallOpname(lhnode, minusName, 2));
+            lexerNextToken(parse->lex);
             nodesAdd(&node->args, parseMult(parse));
             lhnode = (INode*)node;
         }
@@ -540,20 +575,20 @@ INode *parseAdd(ParseState *parse) {
 INode *parseShift(ParseState *parse) {
     INode *lhnode;
     // Prefix '<<' or '>>' implies 'this'
-    if (lexIsToken(ShlToken) || lexIsToken(ShrToken))
-        lhnode = (INode *)newNameUseNode(thisName);
+    if (lexerIsToken(parse->lex, ShlToken) || lexerIsToken(parse->lex, ShrToken))
+        lhnode = (INode *)parsePos(parse, newNameUseNode(thisName));
     else
         lhnode = parseAdd(parse);
     while (1) {
-        if (lexIsToken(ShlToken)) {
-            FnCallNode *node = newFnCallOpname(lhnode, shlName, 2);
-            lexNextToken();
+        if (lexerIsToken(parse->lex, ShlToken)) {
+            FnCallNode *node = parsePos(parse, newFnCallOpname(lhnode, shlName, 2));
+            lexerNextToken(parse->lex);
             nodesAdd(&node->args, parseAdd(parse));
             lhnode = (INode*)node;
         }
-        else if (lexIsToken(ShrToken)) {
-            FnCallNode *node = newFnCallOpname(lhnode, shrName, 2);
-            lexNextToken();
+        else if (lexerIsToken(parse->lex, ShrToken)) {
+            FnCallNode *node = parsePos(parse, newFnCallOpname(lhnode, shrName, 2));
+            lexerNextToken(parse->lex);
             nodesAdd(&node->args, parseAdd(parse));
             lhnode = (INode*)node;
         }
@@ -566,9 +601,9 @@ INode *parseShift(ParseState *parse) {
 INode *parseAnd(ParseState *parse) {
     INode *lhnode = parseShift(parse);
     while (1) {
-        if (lexIsToken(AmperToken) && !lexIsStmtBreak()) {
-            FnCallNode *node = newFnCallOpname(lhnode, andName, 2);
-            lexNextToken();
+        if (lexerIsToken(parse->lex, AmperToken) && !lexerIsStmtBreak(parse->lex)) {
+            FnCallNode *node = parsePos(parse, newFnCallOpname(lhnode, andName, 2));
+            lexerNextToken(parse->lex);
             nodesAdd(&node->args, parseShift(parse));
             lhnode = (INode*)node;
         }
@@ -581,9 +616,9 @@ INode *parseAnd(ParseState *parse) {
 INode *parseXor(ParseState *parse) {
     INode *lhnode = parseAnd(parse);
     while (1) {
-        if (lexIsToken(CaretToken)) {
-            FnCallNode *node = newFnCallOpname(lhnode, xorName, 2);
-            lexNextToken();
+        if (lexerIsToken(parse->lex, CaretToken)) {
+            FnCallNode *node = parsePos(parse, newFnCallOpname(lhnode, xorName, 2));
+            lexerNextToken(parse->lex);
             nodesAdd(&node->args, parseAnd(parse));
             lhnode = (INode*)node;
         }
@@ -596,9 +631,9 @@ INode *parseXor(ParseState *parse) {
 INode *parseOr(ParseState *parse) {
     INode *lhnode = parseXor(parse);
     while (1) {
-        if (lexIsToken(BarToken) && !lexIsStmtBreak()) {
-            FnCallNode *node = newFnCallOpname(lhnode, orName, 2);
-            lexNextToken();
+        if (lexerIsToken(parse->lex, BarToken) && !lexerIsStmtBreak(parse->lex)) {
+            FnCallNode *node = parsePos(parse, newFnCallOpname(lhnode, orName, 2));
+            lexerNextToken(parse->lex);
             nodesAdd(&node->args, parseXor(parse));
             lhnode = (INode*)node;
         }
@@ -612,7 +647,7 @@ INode *parseCmp(ParseState *parse) {
     INode *lhnode = parseOr(parse);
     char *cmpop;
 
-    switch (lex->toktype) {
+    switch (parse->lex->toktype) {
     case EqToken:  cmpop = "=="; break;
     case NeToken:  cmpop = "!="; break;
     case LtToken:  cmpop = "<"; break;
@@ -620,9 +655,9 @@ INode *parseCmp(ParseState *parse) {
     case GtToken:  cmpop = ">"; break;
     case GeToken:  cmpop = ">="; break;
     default:
-        if (lexIsToken(IsToken) && !lexIsStmtBreak()) {
-            CastNode *node = newIsNode(lhnode, unknownType);
-            lexNextToken();
+        if (lexerIsToken(parse->lex, IsToken) && !lexerIsStmtBreak(parse->lex)) {
+            CastNode *node = parsePos(parse, newIsNode(lhnode, unknownType));
+            lexerNextToken(parse->lex);
             node->typ = parseVtype(parse);
             return (INode*)node;
         }
@@ -630,17 +665,17 @@ INode *parseCmp(ParseState *parse) {
             return lhnode;
     }
 
-    FnCallNode *node = newFnCallOp(lhnode, cmpop, 2);
-    lexNextToken();
+    FnCallNode *node = parsePos(parse, newFnCallOp(lhnode, cmpop, 2));
+    lexerNextToken(parse->lex);
     nodesAdd(&node->args, parseOr(parse));
     return (INode*)node;
 }
 
 // Parse 'not' logical operator
 INode *parseNotLogic(ParseState *parse) {
-    if (lexIsToken(NotToken)) {
-        LogicNode *node = newLogicNode(NotLogicTag);
-        lexNextToken();
+    if (lexerIsToken(parse->lex, NotToken)) {
+        LogicNode *node = parsePos(parse, newLogicNode(NotLogicTag));
+        lexerNextToken(parse->lex);
         node->lexp = parseNotLogic(parse);
         return (INode*)node;
     }
@@ -650,9 +685,9 @@ INode *parseNotLogic(ParseState *parse) {
 // Parse 'and' logical operator
 INode *parseAndLogic(ParseState *parse) {
     INode *lhnode = parseNotLogic(parse);
-    while (lexIsToken(AndToken)) {
-        LogicNode *node = newLogicNode(AndLogicTag);
-        lexNextToken();
+    while (lexerIsToken(parse->lex, AndToken)) {
+        LogicNode *node = parsePos(parse, newLogicNode(AndLogicTag));
+        lexerNextToken(parse->lex);
         node->lexp = lhnode;
         node->rexp = parseNotLogic(parse);
         lhnode = (INode*)node;
@@ -663,9 +698,9 @@ INode *parseAndLogic(ParseState *parse) {
 // Parse 'or' logical operator
 INode *parseOrExpr(ParseState *parse) {
     INode *lhnode = parseAndLogic(parse);
-    while (lexIsToken(OrToken)) {
-        LogicNode *node = newLogicNode(OrLogicTag);
-        lexNextToken();
+    while (lexerIsToken(parse->lex, OrToken)) {
+        LogicNode *node = parsePos(parse, newLogicNode(OrLogicTag));
+        lexerNextToken(parse->lex);
         node->lexp = lhnode;
         node->rexp = parseAndLogic(parse);
         lhnode = (INode*)node;
@@ -681,11 +716,11 @@ INode *parseSimpleExpr(ParseState *parse) {
 // Parse a comma-separated expression tuple
 INode *parseTuple(ParseState *parse) {
     INode *exp = parseSimpleExpr(parse);
-    if (lexIsToken(CommaToken)) {
-        TupleNode *tuple = newTupleNode(4);
+    if (lexerIsToken(parse->lex, CommaToken)) {
+        TupleNode *tuple = parsePos(parse, newTupleNode(4));
         nodesAdd(&tuple->elems, exp);
-        while (lexIsToken(CommaToken)) {
-            lexNextToken();
+        while (lexerIsToken(parse->lex, CommaToken)) {
+            lexerNextToken(parse->lex);
             nodesAdd(&tuple->elems, parseSimpleExpr(parse));
         }
         return (INode*)tuple;
@@ -696,18 +731,18 @@ INode *parseTuple(ParseState *parse) {
 
 // Parse an operator assignment
 INode *parseOpEq(ParseState *parse, INode *lval, Name *opeqname) {
-    FnCallNode *node = newFnCallOpname(lval, opeqname, 2);
+    FnCallNode *node = parsePos(parse, newFnCallOpname(lval, opeqname, 2));
     node->flags |= FlagOpAssgn | FlagLvalOp;
-    lexNextToken();
+    lexerNextToken(parse->lex);
     nodesAdd(&node->args, parseAnyExpr(parse));
     return (INode*)node;
 }
 
 // Parse the append operator (<-)
 INode *parseAppend(ParseState *parse, INode *lval) {
-    FnCallNode *node = newFnCallOpname(lval, lessDashName, 2);
+    FnCallNode *node = parsePos(parse, newFnCallOpname(lval, lessDashName, 2));
     node->flags |= FlagOpAssgn | FlagLvalOp;
-    lexNextToken();
+    lexerNextToken(parse->lex);
     nodesAdd(&node->args, parseTuple(parse));  // Note: if we have a tuple, is lowered in fncall name resolve
     return (INode*)node;
 }
@@ -715,31 +750,31 @@ INode *parseAppend(ParseState *parse, INode *lval) {
 // Parse an assignment expression
 INode *parseAssign(ParseState *parse) {
     // Prefix <- operator applies to 'this'
-    if (lexIsToken(LessDashToken)) {
-        return parseAppend(parse, (INode*)newNameUseNode(thisName));
+    if (lexerIsToken(parse->lex, LessDashToken)) {
+        return parseAppend(parse, (INode*)parsePos(parse, newNameUseNode(thisName)));
     }
 
     INode *lval = parseTuple(parse);
-    switch (lex->toktype) {
+    switch (parse->lex->toktype) {
     case AssgnToken:
     {
-        lexNextToken();
+        lexerNextToken(parse->lex);
         INode *rval = parseAnyExpr(parse);
-        return (INode*)newAssignNode(NormalAssign, lval, rval);
+        return (INode*)parsePos(parse, newAssignNode(NormalAssign, lval, rval));
     }
 
     case LAssgnToken:
     {
-        lexNextToken();
+        lexerNextToken(parse->lex);
         INode *rval = parseAnyExpr(parse);
-        return (INode*)newAssignNode(LeftAssign, lval, rval);
+        return (INode*)parsePos(parse, newAssignNode(LeftAssign, lval, rval));
     }
 
     case SwapToken:
     {
-        lexNextToken();
+        lexerNextToken(parse->lex);
         INode *rval = parseAnyExpr(parse);
-        return (INode*)newSwapNode(lval, rval);
+        return (INode*)parsePos(parse, newSwapNode(lval, rval));
     }
 
     case PlusEqToken:
@@ -19,10 +19,10 @@
 INode *parseEach(ParseState *parse, Name *lifesym, int stmtflag);
 
 // This helper routine inserts 'break if !condexp' at beginning of block
-void parseInsertWhileBreak(INode *blk, INode *condexp) {
+void parseInsertWhileBreak(ParseState *parse, INode *blk, INode *condexp) {
     BreakRetNode *breaknode = newBreakNode();
     inodeLexCopy((INode*)breaknode, condexp);
-    breaknode->exp = (INode*)newNilLitNode();
+    breaknode->exp = (INode*)parsePos(parse, newNilLitNode());
     BlockNode *ifblk = newBlockNode();
     inodeLexCopy((INode*)ifblk, condexp);
     nodesAdd(&ifblk->stmts, (INode*)breaknode);
@@ -39,41 +39,41 @@ void parseInsertWhileBreak(INode *blk, INode *condexp) {
 // Parse an expression statement within a function
 INode *parseExpStmt(ParseState *parse) {
     INode *node = parseAnyExpr(parse);
-    parseEndOfStatement();
+    parseEndOfStatement(parse);
     return node;
 }
 
 // Parse a return statement
 INode *parseReturn(ParseState *parse) {
-    BreakRetNode *stmtnode = newReturnNode();
-    lexNextToken(); // Skip past 'return'
-    stmtnode->exp = parseIsEndOfStatement()? (INode*)newNilLitNode() : parseAnyExpr(parse);
-    parseEndOfStatement();
+    BreakRetNode *stmtnode = parsePos(parse, newReturnNode());
+    lexerNextToken(parse->lex); // Skip past 'return'
+    stmtnode->exp = parseIsEndOfStatement(parse)? (INode*)parsePos(parse, newNilLitNode()) : parseAnyExpr(parse);
+    parseEndOfStatement(parse);
     return (INode*)stmtnode;
 }
 
 // Parses a variable bound to a pattern match on a value
 // (it looks like, and is returned as, a variable declaration)
 VarDclNode *parseBindVarDcl(ParseState *parse) {
-    INode *perm = parsePerm();
+    INode *perm = parsePerm(parse);
     INode *permdcl = perm==unknownType? unknownType : iTypeGetTypeDcl(perm);
     if (permdcl != (INode*)mutPerm && permdcl != (INode*)immPerm)
         errorMsgNode(perm, ErrorInvType, "Permission not valid for pattern match binding");
 
     // Obtain variable's name
-    if (!lexIsToken(IdentToken)) {
-        errorMsgLex(ErrorNoIdent, "Expected variable name for declaration");
-        return newVarDclFull(anonName, VarDclTag, unknownType, perm, NULL);
+    if (!lexerIsToken(parse->lex, IdentToken)) {
+        errorMsgLexer(parse->lex, ErrorNoIdent, "Expected variable name for declaration");
+        return parsePos(parse, newVarDclFull(anonName, VarDclTag, unknownType, perm, NULL));
     }
-    VarDclNode *varnode = newVarDclNode(lex->val.ident, VarDclTag, perm);
-    lexNextToken();
+    VarDclNode *varnode = parsePos(parse, newVarDclNode(parse->lex->val.ident, VarDclTag, perm));
+    lexerNextToken(parse->lex);
 
     // Get type
     INode *vtype;
     if ((vtype = parseVtype(parse)) != unknownType)
         varnode->vtype = vtype;
     else {
-        errorMsgLex(ErrorInvType, "Expected type specification for pattern match binding");
+        errorMsgLexer(parse->lex, ErrorInvType, "Expected type specification for pattern match binding");
         varnode->vtype = unknownType;
     }
 
@@ -83,8 +83,8 @@ VarDclNode *parseBindVarDcl(ParseState *parse) {
 // De-sugar a variable bound pattern match
 void parseBoundMatch(ParseState *parse, IfNode *ifnode, NameUseNode *expnamenode, VarDclNode *valnode) {
     // We will desugar a variable declaration into using a pattern match and re-cast
-    CastNode *isnode = newIsNode((INode*)expnamenode, unknownType);
-    CastNode *castnode = newConvCastNode((INode*)expnamenode, unknownType);
+    CastNode *isnode = parsePos(parse, newIsNode((INode*)expnamenode, unknownType));
+    CastNode *castnode = parsePos(parse, newConvCastNode((INode*)expnamenode, unknownType));
 
     // Parse the variable-bind into a vardcl,
     // then preserve its desired type into both the 'is' and 'cast' nodes
@@ -95,10 +95,10 @@ void parseBoundMatch(ParseState *parse, IfNode *ifnode, NameUseNode *expnamenode
 
     // If value expression is needed, obtain it also
     if (valnode != NULL) {
-        if (lexIsToken(AssgnToken))
-            lexNextToken();
+        if (lexerIsToken(parse->lex, AssgnToken))
+            lexerNextToken(parse->lex);
         else {
-            errorMsgLex(ErrorInvType, "Expected '=' followed by value to match against");
+            errorMsgLexer(parse->lex, ErrorInvType, "Expected '=' followed by value to match against");
         }
         valnode->value = parseSimpleExpr(parse);
     }
@@ -111,17 +111,17 @@ void parseBoundMatch(ParseState *parse, IfNode *ifnode, NameUseNode *expnamenode
 
 // Parse if statement/expression
 INode *parseIf(ParseState *parse) {
-    IfNode *ifnode = newIfNode();
+    IfNode *ifnode = parsePos(parse, newIfNode());
     INode *retnode = (INode*)ifnode;
-    lexNextToken();
+    lexerNextToken(parse->lex);
     // To handle bound pattern match, we need to de-sugar:
     // - 'if' is wrapped in a block, where we first capture the value in a variable
     // - The conditional turns into an 'is' check
     // - The first statement in the block actually binds the var to the re-cast value
-    if (lexIsToken(PermToken)) {
-        BlockNode *blknode = newBlockNode();
-        VarDclNode *valnode = newVarDclFull(anonName, VarDclTag, unknownType, (INode*)immPerm, NULL);
-        NameUseNode *valnamenode = newNameUseNode(anonName);
+    if (lexerIsToken(parse->lex, PermToken)) {
+        BlockNode *blknode = parsePos(parse, newBlockNode());
+        VarDclNode *valnode = parsePos(parse, newVarDclFull(anonName, VarDclTag, unknownType, (INode*)immPerm, NULL));
+        NameUseNode *valnamenode = parsePos(parse, newNameUseNode(anonName));
         valnamenode->tag = VarNameUseTag;
         valnamenode->dclnode = (INode*)valnode;
         nodesAdd(&blknode->stmts, (INode*)valnode);
@@ -136,33 +136,33 @@ INode *parseIf(ParseState *parse) {
     while (1) {
         // Process final else clause and break loop
         // Note: this code makes "else if" equivalent to "elif"
-        if (lexIsToken(ElseToken)) {
-            lexNextToken();
-            if (!lexIsToken(IfToken)) {
+        if (lexerIsToken(parse->lex, ElseToken)) {
+            lexerNextToken(parse->lex);
+            if (!lexerIsToken(parse->lex, IfToken)) {
                 nodesAdd(&ifnode->condblk, elseCond); // else distinguished by a elseCond
                 nodesAdd(&ifnode->condblk, parseExprBlock(parse, 0));
                 break;
             }
         }
-        else if (!lexIsToken(ElifToken))
+        else if (!lexerIsToken(parse->lex, ElifToken))
             break;
 
         // Elif processing
-        lexNextToken();
+        lexerNextToken(parse->lex);
         // To handle bound pattern match, we need to de-sugar:
         // - 'if' is wrapped in a block, where we first capture the value in a variable
         // - The conditional turns into an 'is' check
         // - The first statement in the block actually binds the var to the re-cast value
-        if (lexIsToken(PermToken)) {
-            BlockNode *blknode = newBlockNode();
+        if (lexerIsToken(parse->lex, PermToken)) {
+            BlockNode *blknode = parsePos(parse, newBlockNode());
             nodesAdd(&ifnode->condblk, elseCond);
             nodesAdd(&ifnode->condblk, (INode*)blknode);
-            VarDclNode *valnode = newVarDclFull(anonName, VarDclTag, unknownType, (INode*)immPerm, NULL);
-            NameUseNode *valnamenode = newNameUseNode(anonName);
+            VarDclNode *valnode = parsePos(parse, newVarDclFull(anonName, VarDclTag, unknownType, (INode*)immPerm, NULL));
+            NameUseNode *valnamenode = parsePos(parse, newNameUseNode(anonName));
             valnamenode->tag = VarNameUseTag;
             valnamenode->dclnode = (INode*)valnode;
             nodesAdd(&blknode->stmts, (INode*)valnode);
-            ifnode = newIfNode();
+            ifnode = parsePos(parse, newIfNode());
             nodesAdd(&blknode->stmts, (INode*)ifnode);
             parseBoundMatch(parse, ifnode, valnamenode, valnode);
         }
@@ -179,37 +179,37 @@ INode *parseMatch(ParseState *parse) {
     // 'match' is de-sugared into a block:
     // - vardcl that capture the expression in a variable
     // - if .. elif .. else sequence for all the match cases
-    BlockNode *blknode = newBlockNode();
-    IfNode *ifnode = newIfNode();
+    BlockNode *blknode = parsePos(parse, newBlockNode());
+    IfNode *ifnode = parsePos(parse, newIfNode());
 
     // Pick up the expression in a variable, then start the block
-    lexNextToken();
-    VarDclNode *expdclnode = newVarDclNode(anonName, VarDclTag, (INode*)immPerm);
-    NameUseNode *expnamenode = newNameUseNode(anonName);
+    lexerNextToken(parse->lex);
+    VarDclNode *expdclnode = parsePos(parse, newVarDclNode(anonName, VarDclTag, (INode*)immPerm));
+    NameUseNode *expnamenode = parsePos(parse, newNameUseNode(anonName));
     expnamenode->tag = VarNameUseTag;
     expnamenode->dclnode = (INode*)expdclnode;
     expdclnode->value = parseSimpleExpr(parse);
 
     // Parse all cases
-    parseBlockStart();
-    while (!parseBlockEnd()) {
-        lexStmtStart();
+    parseBlockStart(parse);
+    while (!parseBlockEnd(parse)) {
+        lexerStmtStart(parse->lex);
         // Handle pattern that begins with 'case'
-        if (lexIsToken(CaseToken)) {
-            lexNextToken(); // consume the 'case' token
+        if (lexerIsToken(parse->lex, CaseToken)) {
+            lexerNextToken(parse->lex); // consume the 'case' token
             // Handle bound variable pattern
-            if (lexIsToken(PermToken)) {
+            if (lexerIsToken(parse->lex, PermToken)) {
                 parseBoundMatch(parse, ifnode, expnamenode, NULL);
             }
-            else if (lexIsToken(IsToken)) {
-                CastNode *isnode = newIsNode((INode *)expnamenode, unknownType);
-                lexNextToken();
+            else if (lexerIsToken(parse->lex, IsToken)) {
+                CastNode *isnode = parsePos(parse, newIsNode((INode *)expnamenode, unknownType));
+                lexerNextToken(parse->lex);
                 isnode->typ = parseVtype(parse);
                 nodesAdd(&ifnode->condblk, (INode *)isnode);
                 nodesAdd(&ifnode->condblk, parseExprBlock(parse, 0));
-            } else if (lexIsToken(EqToken)) {
-                FnCallNode *callnode = newFnCallOp((INode *)expnamenode, "==", 2);
-                lexNextToken();
+            } else if (lexerIsToken(parse->lex, EqToken)) {
+                FnCallNode *callnode = parsePos(parse, newFnCallOp((INode *)expnamenode, "==", 2));
+                lexerNextToken(parse->lex);
                 nodesAdd(&callnode->args, parseSimpleExpr(parse));
                 nodesAdd(&ifnode->condblk, (INode *)callnode);
                 nodesAdd(&ifnode->condblk, parseExprBlock(parse, 0));
@@ -217,12 +217,12 @@ INode *parseMatch(ParseState *parse) {
                 nodesAdd(&ifnode->condblk, parseSimpleExpr(parse));
                 nodesAdd(&ifnode->condblk, parseExprBlock(parse, 0));
             }
-        } else if (lexIsToken(ElseToken)) {
-            lexNextToken();
+        } else if (lexerIsToken(parse->lex, ElseToken)) {
+            lexerNextToken(parse->lex);
             nodesAdd(&ifnode->condblk, elseCond); // else distinguished by a elseCond condition
             nodesAdd(&ifnode->condblk, parseExprBlock(parse, 0));
         } else {
-            errorMsgLex(ErrorBadTerm, "Parser Error: should be either case or else");
+            errorMsgLexer(parse->lex, ErrorBadTerm, "Parser Error: should be either case or else");
             return (INode *)blknode;
         }
     }
@@ -233,9 +233,9 @@ INode *parseMatch(ParseState *parse) {
 
 // Parse while block
 INode *parseWhile(ParseState *parse, Name *lifesym, int stmtflag) {
-    lexNextToken();
+    lexerNextToken(parse->lex);
     INode *condexp = NULL;
-    if (!parseHasBlock()) {
+    if (!parseHasBlock(parse)) {
         if (!stmtflag)
             errorMsg(ErrorNoLoop, "while with condition expression may not be used as an expression");
         condexp = parseSimpleExpr(parse);
@@ -243,7 +243,7 @@ INode *parseWhile(ParseState *parse, Name *lifesym, int stmtflag) {
     BlockNode *loopnode = (BlockNode*)parseExprBlock(parse, 1);
     loopnode->lifesym = lifesym;
     if (condexp)
-        parseInsertWhileBreak((INode*)loopnode, condexp);
+        parseInsertWhileBreak(parse, (INode*)loopnode, condexp);
     return (INode *)loopnode;
 }
 
@@ -251,21 +251,21 @@ INode *parseWhile(ParseState *parse, Name *lifesym, int stmtflag) {
 INode *parseEach(ParseState *parse, Name *lifesym, int stmtflag) {
     if (!stmtflag)
         errorMsg(ErrorNoLoop, "each may not be used as an expression");
-    BlockNode *outerblk = newBlockNode();   // surrounding block scope for isolating 'each' vars
+    BlockNode *outerblk = parsePos(parse, newBlockNode());   // surrounding block scope for isolating 'each' vars
 
     // Obtain all the parsed pieces
-    lexNextToken();
-    if (!lexIsToken(IdentToken)) {
-        errorMsgLex(ErrorNoVar, "Missing variable name");
+    lexerNextToken(parse->lex);
+    if (!lexerIsToken(parse->lex, IdentToken)) {
+        errorMsgLexer(parse->lex, ErrorNoVar, "Missing variable name");
         return (INode *)outerblk;
     }
-    Name* elemname = lex->val.ident;
-    lexNextToken();
-    if (!lexIsToken(InToken)) {
-        errorMsgLex(ErrorBadTok, "Missing 'in'");
+    Name* elemname = parse->lex->val.ident;
+    lexerNextToken(parse->lex);
+    if (!lexerIsToken(parse->lex, InToken)) {
+        errorMsgLexer(parse->lex, ErrorBadTok, "Missing 'in'");
         return (INode *)outerblk;
     }
-    lexNextToken();
+    lexerNextToken(parse->lex);
     INode *iter = parseSimpleExpr(parse);
     INode *step = NULL;
     int isrange = 0;
@@ -276,8 +276,8 @@ INode *parseEach(ParseState *parse, Name *lifesym, int stmtflag) {
         else if (methodnm == geName || methodnm == gtName)
             isrange = -1;
     }
-    if (isrange && lexIsToken(ByToken)) {
-        lexNextToken();
+    if (isrange && lexerIsToken(parse->lex, ByToken)) {
+        lexerNextToken(parse->lex);
         step = parseSimpleExpr(parse);
     }
     BlockNode *loopnode = (BlockNode*)parseExprBlock(parse, 1);
@@ -287,22 +287,30 @@ INode *parseEach(ParseState *parse, Name *lifesym, int stmtflag) {
     // { mut elemname = initial; while elemname <= iterend { ... ; elemname += step}}
     if (isrange) {
         FnCallNode *itercmp = (FnCallNode *)iter;
-        VarDclNode *elemdcl = newVarDclNode(elemname, VarDclTag, (INode*)mutPerm);
+        VarDclNode *elemdcl = parsePos(parse, newVarDclNode(elemname, VarDclTag, (INode*)mutPerm));
         elemdcl->value = itercmp->objfn;
         nodesAdd(&((BlockNode*)outerblk)->stmts, (INode*)elemdcl);
-        itercmp->objfn = (INode*)newNameUseNode(elemname);
+        itercmp->objfn = (INode*)parsePos(parse, newNameUseNode(elemname));
+        // An ascending range variable stays below its limit within the loop body,
+        // which lets codegen skip bounds checks when indexing by it (see flowUseLval)
+        if (isrange > 0) {
+            elemdcl->rangelimit = nodesGet(itercmp->args, 0);
+            elemdcl->rangeloop = (INode*)loopnode;
+            if (itercmp->methfld->namesym == leName)
+                elemdcl->flowflags |= VarRangeIncl;
+        }
         if (step) {
-            FnCallNode *pluseq = newFnCallOpname((INode*)newNameUseNode(elemname), plusEqName, 1);
-            pluseq->flags |= FlagOpAssgn | FlagLvalOp;
+            FnCallNode *pluseq = parsePos(parse, newFnCallOpname((INode*)parsePos(parse, newNameUseNode(elemname)), plusEqName, 1));
+            pluseq->flags |= FlagOpAssgn | FlagLvalOp | FlagRangeStep;
             nodesAdd(&pluseq->args, step);
             nodesAdd(&loopnode->stmts, (INode*)pluseq);
         }
         else {
-            INode *incr = (INode *)newFnCallOpname((INode *)newNameUseNode(elemname), isrange > 0 ? incrPostName : decrPostName, 0);
-            incr->flags |= FlagLvalOp;
+            INode *incr = (INode *)parsePos(parse, newFnCallOpname((INode *)parsePos(parse, newNameUseNode(elemname)), isrange > 0 ? incrPostName : decrPostName, 0));
+            incr->flags |= FlagLvalOp | FlagRangeStep;
             nodesAdd(&loopnode->stmts, incr);
         }
-        parseInsertWhileBreak((INode*)loopnode, iter);
+        parseInsertWhileBreak(parse, (INode*)loopnode, iter);
         nodesAdd(&outerblk->stmts, (INode*)loopnode);
     }
     return (INode *)outerblk;
@@ -311,25 +319,25 @@ INode *parseEach(ParseState *parse, Name *lifesym, int stmtflag) {
 // Parse a lifetime variable, followed by colon and then a loop
 // 'stmtflag' indicates it is a statement vs. an expression (loop)
 INode *parseLifetime(ParseState *parse, int stmtflag) {
-    Name *lifesym = lex->val.ident;
-    lexNextToken();
-    if (lexIsToken(ColonToken))
-        lexNextToken();
+    Name *lifesym = parse->lex->val.ident;
+    lexerNextToken(parse->lex);
+    if (lexerIsToken(parse->lex, ColonToken))
+        lexerNextToken(parse->lex);
     else
-        errorMsgLex(ErrorBadTok, "Missing ':' after lifetime");
+        errorMsgLexer(parse->lex, ErrorBadTok, "Missing ':' after lifetime");
 
-    if (lexIsToken(WhileToken))
+    if (lexerIsToken(parse->lex, WhileToken))
         return parseWhile(parse, lifesym, stmtflag);
-    else if (lexIsToken(EachToken))
+    else if (lexerIsToken(parse->lex, EachToken))
         return parseEach(parse, lifesym, stmtflag);
-    errorMsgLex(ErrorBadTok, "A lifetime may only be followed by a loop/while/each");
+    errorMsgLexer(parse->lex, ErrorBadTok, "A lifetime may only be followed by a loop/while/each");
     return NULL;
 }
 
 // Parse a 'with' block, setting 'this' to the expression at start of block
 INode *parseWith(ParseState *parse) {
-    lexNextToken();
-    VarDclNode *this = newVarDclFull(thisName, VarDclTag, unknownType, (INode*)immPerm, NULL);
+    lexerNextToken(parse->lex);
+    VarDclNode *this = parsePos(parse, newVarDclFull(thisName, VarDclTag, unknownType, (INode*)immPerm, NULL));
     this->value = parseSimpleExpr(parse);
     BlockNode *blk = (BlockNode*)parseExprBlock(parse, 0);
     nodesInsert(&blk->stmts, (INode*)this, 0);
@@ -338,17 +346,17 @@ INode *parseWith(ParseState *parse) {
 
 // Parse a block of statements/expressions
 INode *parseExprBlock(ParseState *parse, int isloop) {
-    BlockNode *blk = isloop? newLoopBlockNode() : newBlockNode();
+    BlockNode *blk = isloop? parsePos(parse, newLoopBlockNode()) : parsePos(parse, newBlockNode());
     if (blk->stmts == NULL)
         blk->stmts = newNodes(8);
 
-    parseBlockStart();
+    parseBlockStart(parse);
 
-    while (!parseBlockEnd()) {
-        lexStmtStart();
-        switch (lex->toktype) {
+    while (!parseBlockEnd(parse)) {
+        lexerStmtStart(parse->lex);
+        switch (parse->lex->toktype) {
         case SemiToken:
-            lexNextToken();
+            lexerNextToken(parse->lex);
             break;
 
         case RetToken:
@@ -381,27 +389,27 @@ INode *parseExprBlock(ParseState *parse, int isloop) {
 
         case BreakToken:
         {
-            BreakRetNode *node = newBreakNode();
-            lexNextToken();
-            if (lexIsToken(LifetimeToken)) {
-                node->life = (INode*)newNameUseNode(lex->val.ident);
-                lexNextToken();
+            BreakRetNode *node = parsePos(parse, newBreakNode());
+            lexerNextToken(parse->lex);
+            if (lexerIsToken(parse->lex, LifetimeToken)) {
+                node->life = (INode*)parsePos(parse, newNameUseNode(parse->lex->val.ident));
+                lexerNextToken(parse->lex);
             }
-            node->exp = parseIsEndOfStatement()? (INode*)newNilLitNode() : parseAnyExpr(parse);
-            parseEndOfStatement();
+            node->exp = parseIsEndOfStatement(parse)? (INode*)parsePos(parse, newNilLitNode()) : parseAnyExpr(parse);
+            parseEndOfStatement(parse);
             nodesAdd(&blk->stmts, (INode*)node);
             break;
         }
 
         case ContinueToken:
         {
-            BreakRetNode *node = newContinueNode();
-            lexNextToken();
-            if (lexIsToken(LifetimeToken)) {
-                node->life = (INode*)newNameUseNode(lex->val.ident);
-                lexNextToken();
+            BreakRetNode *node = parsePos(parse, newContinueNode());
+            lexerNextToken(parse->lex);
+            if (lexerIsToken(parse->lex, LifetimeToken)) {
+                node->life = (INode*)parsePos(parse, newNameUseNode(parse->lex->val.ident));
+                lexerNextToken(parse->lex);
             }
-            parseEndOfStatement();
+            parseEndOfStatement(parse);
             nodesAdd(&blk->stmts, (INode*)node);
             break;
         }
@@ -413,7 +421,7 @@ INode *parseExprBlock(ParseState *parse, int isloop) {
         // A local variable declaration, if it begins with a permission
         case PermToken:
             nodesAdd(&blk->stmts, (INode*)parseVarDcl(parse, immPerm, ParseMayConst|ParseMaySig|ParseMayImpl));
-            parseEndOfStatement();
+            parseEndOfStatement(parse);
             break;
 
         default:
@@ -19,134 +19,142 @@
 #include <stdio.h>
 #include <string.h>
 
+// Give a newly created node the source position of the parser's current token
+void *parsePos(ParseState *parse, void *node) {
+    INode *inode = (INode*)node;
+    inode->lexer = parse->lex;
+    inode->srcoff = (uint32_t)(parse->lex->tokp - parse->lex->source);
+    return node;
+}
+
 // Skip to next statement for error recovery
-void parseSkipToNextStmt() {
+void parseSkipToNextStmt(ParseState *parse) {
     // Ensure we are always moving forwards, line by line
-    if (lexIsEndOfLine() && !lexIsToken(SemiToken) && !lexIsToken(EofToken) && !lexIsToken(RCurlyToken))
-        lexNextToken();
+    if (lexerIsEndOfLine(parse->lex) && !lexerIsToken(parse->lex, SemiToken) && !lexerIsToken(parse->lex, EofToken) && !lexerIsToken(parse->lex, RCurlyToken))
+        lexerNextToken(parse->lex);
     while (1) {
         // Consume semicolon as end-of-statement
-        if (lexIsToken(SemiToken)) {
-            lexNextToken();
+        if (lexerIsToken(parse->lex, SemiToken)) {
+            lexerNextToken(parse->lex);
             return;
         }
         // Treat end-of-line, end-of-file, or '}' as end-of-statement
         // (clearly end-of-line might *not* be end-of-statement)
-        if (lexIsEndOfLine() || lexIsToken(EofToken) || lexIsToken(RCurlyToken))
+        if (lexerIsEndOfLine(parse->lex) || lexerIsToken(parse->lex, EofToken) || lexerIsToken(parse->lex, RCurlyToken))
             return;
 
-        lexNextToken();
+        lexerNextToken(parse->lex);
     }
 }
 
 // Is this end-of-statement? if ';', '}', or end-of-file
-int parseIsEndOfStatement() {
-    return (lex->toktype == SemiToken || lex->toktype == RCurlyToken || lex->toktype == EofToken
-        || lexIsStmtBreak());
+int parseIsEndOfStatement(ParseState *parse) {
+    return (parse->lex->toktype == SemiToken || parse->lex->toktype == RCurlyToken || parse->lex->toktype == EofToken
+        || lexerIsStmtBreak(parse->lex));
 }
 
 // We expect optional semicolon since statement has run its course
-void parseEndOfStatement() {
+void parseEndOfStatement(ParseState *parse) {
     // Consume semicolon as end-of-statement signifier, if found
-    if (lex->toktype == SemiToken) {
-        lexNextToken();
+    if (parse->lex->toktype == SemiToken) {
+        lexerNextToken(parse->lex);
         return;
     }
     // If no semi-colon specified, we expect to be at end-of-line,
     // unless next token is '}' or end-of-file
-    if (!lexIsEndOfLine() && lex->toktype != RCurlyToken && lex->toktype != EofToken)
-        errorMsgLex(ErrorNoSemi, "Statement finished? Expected semicolon or end of line.");
+    if (!lexerIsEndOfLine(parse->lex) && parse->lex->toktype != RCurlyToken && parse->lex->toktype != EofToken)
+        errorMsgLexer(parse->lex, ErrorNoSemi, "Statement finished? Expected semicolon or end of line.");
 }
 
 // Return true on '{' or ':'
-int parseHasBlock() {
-    return (lex->toktype == LCurlyToken || lex->toktype == ColonToken);
+int parseHasBlock(ParseState *parse) {
+    return (parse->lex->toktype == LCurlyToken || parse->lex->toktype == ColonToken);
 }
 
 // Expect a block to start, consume its token and set lexer mode
-void parseBlockStart() {
-    if (lex->toktype == LCurlyToken) {
-        lexNextToken();
-        lexBlockStart(FreeFormBlock);
+void parseBlockStart(ParseState *parse) {
+    if (parse->lex->toktype == LCurlyToken) {
+        lexerNextToken(parse->lex);
+        lexerBlockStart(parse->lex, FreeFormBlock);
         return;
     }
-    else if (lex->toktype == ColonToken) {
-        lexNextToken();
-        lexBlockStart(lexIsEndOfLine() ? SigIndentBlock : SameStmtBlock);
+    else if (parse->lex->toktype == ColonToken) {
+        lexerNextToken(parse->lex);
+        lexerBlockStart(parse->lex, lexerIsEndOfLine(parse->lex) ? SigIndentBlock : SameStmtBlock);
         return;
     }
 
     // Generate error and try to recover
-    errorMsgLex(ErrorNoLCurly, "Expected ':' or '{' to start a block");
-    if (lexIsEndOfLine() && lex->curindent > lex->stmtindent) {
-        lexBlockStart(SigIndentBlock);
+    errorMsgLexer(parse->lex, ErrorNoLCurly, "Expected ':' or '{' to start a block");
+    if (lexerIsEndOfLine(parse->lex) && parse->lex->curindent > parse->lex->stmtindent) {
+        lexerBlockStart(parse->lex, SigIndentBlock);
         return;
     }
     // Skip forward to find something we can use
     while (1) {
-        if (lexIsToken(LCurlyToken) || lexIsToken(ColonToken)) {
-            parseBlockStart();
+        if (lexerIsToken(parse->lex, LCurlyToken) || lexerIsToken(parse->lex, ColonToken)) {
+            parseBlockStart(parse);
             return;
         }
-        if (lexIsToken(EofToken))
+        if (lexerIsToken(parse->lex, EofToken))
             break;
-        lexNextToken();
+        lexerNextToken(parse->lex);
     }
 }
 
 // Are we at end of block yet? If so, consume token and reset lexer mode
-int parseBlockEnd() {
-    if (lexIsToken(RCurlyToken) && lex->blkStack[lex->blkStackLvl].blkmode == FreeFormBlock) {
-        lexNextToken();
-        lexBlockEnd();
+int parseBlockEnd(ParseState *parse) {
+    if (lexerIsToken(parse->lex, RCurlyToken) && parse->lex->blkStack[parse->lex->blkStackLvl].blkmode == FreeFormBlock) {
+        lexerNextToken(parse->lex);
+        lexerBlockEnd(parse->lex);
         return 1;
     }
-    if (lexIsBlockEnd()) {
-        lexBlockEnd();
+    if (lexerIsBlockEnd(parse->lex)) {
+        lexerBlockEnd(parse->lex);
         return 1;
     }
-    if (lexIsToken(EofToken)) {
-        errorMsgLex(ErrorNoRCurly, "Expected end of block (e.g., '}')");
+    if (lexerIsToken(parse->lex, EofToken)) {
+        errorMsgLexer(parse->lex, ErrorNoRCurly, "Expected end of block (e.g., '}')");
         return 1;
     }
     return 0;
 }
 
 // Expect closing token (e.g., right parenthesis). If not found, search for it or '}' or ';'
-void parseCloseTok(uint16_t closetok) {
-    if (!lexIsToken(closetok))
-        errorMsgLex(ErrorNoRParen, "Expected right parenthesis - skipping forward to find it");
-    while (!lexIsToken(closetok)) {
-        if (lexIsToken(EofToken) || lexIsToken(SemiToken) || lexIsToken(RCurlyToken))
+void parseCloseTok(ParseState *parse, uint16_t closetok) {
+    if (!lexerIsToken(parse->lex, closetok))
+        errorMsgLexer(parse->lex, ErrorNoRParen, "Expected right parenthesis - skipping forward to find it");
+    while (!lexerIsToken(parse->lex, closetok)) {
+        if (lexerIsToken(parse->lex, EofToken) || lexerIsToken(parse->lex, SemiToken) || lexerIsToken(parse->lex, RCurlyToken))
             return;
-        lexNextToken();
+        lexerNextToken(parse->lex);
     }
-    lexNextToken();
-    lexDecrParens();
+    lexerNextToken(parse->lex);
+    lexerDecrParens(parse->lex);
 }
 
 // Parse a function block
 INode *parseFn(ParseState *parse, uint16_t mayflags) {
-    FnDclNode *fnnode = newFnDclNode(NULL, 0, NULL, NULL);
+    FnDclNode *fnnode = parsePos(parse, newFnDclNode(NULL, 0, NULL, NULL));
 
     // Skip past the 'fn'.
-    lexNextToken();
+    lexerNextToken(parse->lex);
 
     // Process function name, if provided
-    if (lexIsToken(IdentToken)) {
+    if (lexerIsToken(parse->lex, IdentToken)) {
         if (!(mayflags&ParseMayName))
-            errorMsgLex(WarnName, "Unnecessary function name is ignored");
-        fnnode->namesym = lex->val.ident;
+            errorMsgLexer(parse->lex, WarnName, "Unnecessary function name is ignored");
+        fnnode->namesym = parse->lex->val.ident;
         fnnode->genname = &fnnode->namesym->namestr;
-        lexNextToken();
-        if (lexIsToken(LBracketToken)) {
+        lexerNextToken(parse->lex);
+        if (lexerIsToken(parse->lex, LBracketToken)) {
             fnnode->genericinfo = newGenericInfo();
             fnnode->genericinfo->parms = parseGenericParms(parse);
         }
     }
     else {
         if (!(mayflags&ParseMayAnon))
-            errorMsgLex(ErrorNoName, "Function declarations must be named");
+            errorMsgLexer(parse->lex, ErrorNoName, "Function declarations must be named");
     }
 
     // Process the function's signature info.
@@ -154,13 +162,13 @@ INode *parseFn(ParseState *parse, uint16_t mayflags) {
 
     // Handle optional specification that we are declaring an inline function,
     // one whose implementation will be "inlined" into any function that calls it
-    if (lexIsToken(InlineToken)) {
+    if (lexerIsToken(parse->lex, InlineToken)) {
         fnnode->flags |= FlagInline;
-        lexNextToken();
+        lexerNextToken(parse->lex);
     }
 
     // Process statements block that implements function, if provided
-    if (parseHasBlock()) {
+    if (parseHasBlock(parse)) {
         if (!(mayflags&ParseMayImpl))
             errorMsgNode((INode*)fnnode, ErrorBadImpl, "Function/method implementation is not allowed here.");
         fnnode->value = parseExprBlock(parse, 0);
@@ -169,23 +177,23 @@ INode *parseFn(ParseState *parse, uint16_t mayflags) {
         if (!(mayflags&ParseMaySig))
             errorMsgNode((INode*)fnnode, ErrorNoImpl, "Function/method must be implemented.");
         if (!(mayflags&ParseEmbedded))
-            parseEndOfStatement();
+            parseEndOfStatement(parse);
     }
 
     return (INode*) fnnode;
 }
 
 // Parse source filename/path as identifier or string literal
-char *parseFile() {
+char *parseFile(ParseState *parse) {
     char *filename;
-    switch (lex->toktype) {
+    switch (parse->lex->toktype) {
     case IdentToken:
-        filename = &lex->val.ident->namestr;
-        lexNextToken();
+        filename = &parse->lex->val.ident->namestr;
+        lexerNextToken(parse->lex);
         break;
     case StringLitToken:
-        filename = lex->val.strlit;
-        lexNextToken();
+        filename = parse->lex->val.strlit;
+        lexerNextToken(parse->lex);
         break;
     default:
         errorExit(ExitNF, "Invalid source file; expected identifier or string");
@@ -199,16 +207,17 @@ void parseGlobalStmts(ParseState *parse, ModuleNode *mod);
 // Parse include statement
 void parseInclude(ParseState *parse) {
     char *filename;
-    lexNextToken();
-    filename = parseFile();
-    parseEndOfStatement();
+    lexerNextToken(parse->lex);
+    filename = parseFile(parse);
+    parseEndOfStatement(parse);
 
-    lexInjectFile(filename);
+    Lexer *svlex = parse->lex;
+    parse->lex = newLexerFile(svlex, filename);
     parseGlobalStmts(parse, parse->mod);
-    if (lex->toktype != EofToken) {
-        errorMsgLex(ErrorNoEof, "Expected end-of-file");
+    if (parse->lex->toktype != EofToken) {
+        errorMsgLexer(parse->lex, ErrorNoEof, "Expected end-of-file");
     }
-    lexPop();
+    parse->lex = svlex;
 }
 
 char *stdiolib =
@@ -224,32 +233,79 @@ char *stdiolib =
 "mut print = IOStream[0]"
 ;
 
-// Parse imported module
+// Imported modules are not parsed at the import statement that names them.
+// Instead, each newly discovered module is registered with the program and queued,
+// and the queue is drained (in discovery order) once the importing module is done.
+// This keeps the lexer stack shallow for long import chains, and each module's
+// parse no longer depends on being nested inside the parse of its importer.
+//
+// The queue is drained on one thread. Each module has its own lexer (parse->lex),
+// but a module's parse also interns identifiers in the global name table (nametbl.c),
+// hooks its names into that table to find duplicates (modHook), and registers the
+// modules it imports (pgmAddMod). Those, like the shared arenas and error counts
+// noted at FnBodyWork (fndcl.c), would need to be per-thread or locked first.
+typedef struct {
+    ModuleNode *mod;    // The registered (not yet parsed) module
+    char *filename;     // Where to find its source
+    Lexer *from;        // Lexer of the importing source (filename is relative to it)
+} ParseModWork;
+
+static ParseModWork *gParseModQueue = NULL;
+static uint32_t gParseModQueueSz = 0;
+static uint32_t gParseModQueueHead = 0;
+static uint32_t gParseModQueueTail = 0;
+
+// Add a registered module to the parse queue
+void parseQueueModule(ModuleNode *mod, char *filename, Lexer *from) {
+    if (gParseModQueueTail >= gParseModQueueSz) {
+        ParseModWork *oldqueue = gParseModQueue;
+        uint32_t oldsize = gParseModQueueSz;
+        gParseModQueueSz = oldsize == 0 ? 16 : oldsize << 1;
+        gParseModQueue = (ParseModWork*)memAllocBlk(gParseModQueueSz * sizeof(ParseModWork));
+        if (oldsize)
+            memcpy(gParseModQueue, oldqueue, oldsize * sizeof(ParseModWork));
+    }
+    ParseModWork *work = &gParseModQueue[gParseModQueueTail++];
+    work->mod = mod;
+    work->filename = filename;
+    work->from = from;
+}
+
+// Register imported module, queuing it to be parsed later
 ModuleNode *parseImportModule(ParseState *parse, char *filename, Name *modname) {
     // If we already have module, don't re-parse. Just return it.
     ModuleNode *newmod = pgmFindMod(parse->pgm, modname);
     if (newmod)
         return newmod;
 
-    // Let's load and parse the module
+    newmod = pgmAddMod(parse->pgm);
+    newmod->namesym = modname;
+    parseQueueModule(newmod, filename, parse->lex);
+    return newmod;
+}
+
+// Parse the source for a registered, imported module
+void parseModuleSource(ParseState *parse, ModuleNode *newmod, char *filename, Lexer *from) {
+    Lexer *svlex = parse->lex;
     char *svprefix = parse->gennamePrefix;
     ModuleNode *svmod = parse->mod;
+    Name *modname = newmod->namesym;
     nameNewPrefix(&parse->gennamePrefix, &modname->namestr);
 
     if (modname == corelibName)
-        lexInject(corelibSource, "corelib");
+        parse->lex = newLexer(corelibSource, "corelib");
     else if (strcmp(filename, "stdio") == 0)
-        lexInject(stdiolib, "stdio");
+        parse->lex = newLexer(stdiolib, "stdio");
     else
-        lexInjectFile(filename);
-    newmod = pgmAddMod(parse->pgm);
-    newmod->namesym = modname;
+        parse->lex = newLexerFile(from, filename);
+    // Module node was created before its source was lexed: point it at its source
+    parsePos(parse, newmod);
     parse->mod = newmod;
 
     // Auto-import core lib (except into corelib)
     ModuleNode *corelib = pgmFindMod(parse->pgm, corelibName);
     if (corelib && corelib != newmod) {
-        ImportNode *importnode = newImportNode();
+        ImportNode *importnode = parsePos(parse, newImportNode());
         importnode->foldall = 1;
         importnode->module = corelib;
         modAddNode(newmod, NULL, (INode*)importnode);
@@ -257,35 +313,42 @@ ModuleNode *parseImportModule(ParseState *parse, char *filename, Name *modname)
 
     modHook(svmod, newmod);
     parseGlobalStmts(parse, newmod);
-    if (lex->toktype != EofToken) {
-        errorMsgLex(ErrorNoEof, "Expected end-of-file");
+    if (parse->lex->toktype != EofToken) {
+        errorMsgLexer(parse->lex, ErrorNoEof, "Expected end-of-file");
     }
-    lexPop();
     modHook(newmod, svmod);
 
+    parse->lex = svlex;
     parse->mod = svmod;
     parse->gennamePrefix = svprefix;
-    return newmod;
+}
+
+// Parse all queued modules, including any they import, in discovery order
+void parseQueuedModules(ParseState *parse) {
+    while (gParseModQueueHead < gParseModQueueTail) {
+        ParseModWork *work = &gParseModQueue[gParseModQueueHead++];
+        parseModuleSource(parse, work->mod, work->filename, work->from);
+    }
 }
 
 // Parse import statement
 ImportNode *parseImport(ParseState *parse) {
-    ImportNode *importnode = newImportNode();
-    lexNextToken();
-    char *filename = parseFile();
+    ImportNode *importnode = parsePos(parse, newImportNode());
+    lexerNextToken(parse->lex);
+    char *filename = parseFile(parse);
     char *modstr = fileName(filename);
     Name *modname = nametblFind(modstr, strlen(modstr));
 
-    if (lexIsToken(DblColonToken)) {
-        lexNextToken();
-        if (lexIsToken(StarToken)) {
+    if (lexerIsToken(parse->lex, DblColonToken)) {
+        lexerNextToken(parse->lex);
+        if (lexerIsToken(parse->lex, StarToken)) {
             importnode->foldall = 1;
-            lexNextToken();
+            lexerNextToken(parse->lex);
         }
     }
-    parseEndOfStatement();
+    parseEndOfStatement(parse);
 
-    // Parse the imported modules
+    // Register the imported module (it is parsed after the current one)
     ModuleNode *newmod = parseImportModule(parse, filename, modname);
 
     // Add imported module to namespace of existing module
@@ -299,7 +362,7 @@ ImportNode *parseImport(ParseState *parse) {
 // Return NULL if not either
 void parseFnOrVar(ParseState *parse, uint16_t flags) {
 
-    if (lexIsToken(FnToken)) {
+    if (lexerIsToken(parse->lex, FnToken)) {
         FnDclNode *node = (FnDclNode*)parseFn(parse, (flags&FlagExtern)? (ParseMayName | ParseMaySig) : (ParseMayName | ParseMayImpl));
         node->flags |= flags;
         nameGenVarName((VarDclNode *)node, parse->gennamePrefix);
@@ -308,49 +371,49 @@ void parseFnOrVar(ParseState *parse, uint16_t flags) {
     }
 
     // A global variable declaration, if it begins with a permission
-    else if lexIsToken(PermToken) {
+    else if lexerIsToken(parse->lex, PermToken) {
         VarDclNode *node = parseVarDcl(parse, immPerm, ParseMayConst | ((flags&FlagExtern) ? ParseMaySig : ParseMayImpl | ParseMaySig));
         node->flags |= flags;
         node->flowtempflags |= VarInitialized;   // Globals always hold a valid value
-        parseEndOfStatement();
+        parseEndOfStatement(parse);
         nameGenVarName((VarDclNode *)node, parse->gennamePrefix);
         modAddNode(parse->mod, node->namesym, (INode*)node);
     }
     else {
-        errorMsgLex(ErrorBadGloStmt, "Expected function or variable declaration");
-        parseSkipToNextStmt();
+        errorMsgLexer(parse->lex, ErrorBadGloStmt, "Expected function or variable declaration");
+        parseSkipToNextStmt(parse);
         return;
     }
 }
 
 // Parse a list of generic variables and add to the genericnode
 Nodes *parseGenericParms(ParseState *parse) {
-    lexNextToken(); // Go past left square bracket
+    lexerNextToken(parse->lex); // Go past left square bracket
     Nodes *parms = newNodes(2);
-    while (lexIsToken(IdentToken)) {
-        GenVarDclNode *parm = newGVarDclNode(lex->val.ident);
+    while (lexerIsToken(parse->lex, IdentToken)) {
+        GenVarDclNode *parm = parsePos(parse, newGVarDclNode(parse->lex->val.ident));
         nodesAdd(&parms, (INode*)parm);
-        lexNextToken();
-        if (lexIsToken(CommaToken))
-            lexNextToken();
+        lexerNextToken(parse->lex);
+        if (lexerIsToken(parse->lex, CommaToken))
+            lexerNextToken(parse->lex);
     }
-    if (lexIsToken(RBracketToken))
-        lexNextToken();
+    if (lexerIsToken(parse->lex, RBracketToken))
+        lexerNextToken(parse->lex);
     else
-        errorMsgLex(ErrorBadTok, "Expected list of macro/generic parameter ending with square bracket.");
+        errorMsgLexer(parse->lex, ErrorBadTok, "Expected list of macro/generic parameter ending with square bracket.");
     return parms;
 }
 
 // Parse a macro declaration
 MacroDclNode *parseMacro(ParseState *parse) {
-    lexNextToken();
-    if (!lexIsToken(IdentToken)) {
-        errorMsgLex(ErrorBadTok, "Expected a macro name");
-        return newMacroDclNode(anonName);
+    lexerNextToken(parse->lex);
+    if (!lexerIsToken(parse->lex, IdentToken)) {
+        errorMsgLexer(parse->lex, ErrorBadTok, "Expected a macro name");
+        return parsePos(parse, newMacroDclNode(anonName));
     }
-    MacroDclNode *macro = newMacroDclNode(lex->val.ident);
-    lexNextToken();
-    if (lexIsToken(LBracketToken)) {
+    MacroDclNode *macro = parsePos(parse, newMacroDclNode(parse->lex->val.ident));
+    lexerNextToken(parse->lex);
+    if (lexerIsToken(parse->lex, LBracketToken)) {
         macro->parms = parseGenericParms(parse);
     }
     macro->body = parseExprBlock(parse, 0);
@@ -361,9 +424,9 @@ MacroDclNode *parseMacro(ParseState *parse) {
 // modAddNode adds node to module, as needed, including error message for dupes
 void parseGlobalStmts(ParseState *parse, ModuleNode *mod) {
     // Create and populate a Module node for the program
-    while (lex->toktype!=EofToken && !parseBlockEnd()) {
-        lexStmtStart();
-        switch (lex->toktype) {
+    while (parse->lex->toktype!=EofToken && !parseBlockEnd(parse)) {
+        lexerStmtStart(parse->lex);
+        switch (parse->lex->toktype) {
 
         case IncludeToken:
             parseInclude(parse);
@@ -412,22 +475,22 @@ void parseGlobalStmts(ParseState *parse, ModuleNode *mod) {
         // 'extern' qualifier in front of fn or var (block)
         case ExternToken:
         {
-            lexNextToken();
+            lexerNextToken(parse->lex);
             uint16_t extflag = FlagExtern;
-            if (lexIsToken(IdentToken)) {
-                if (strcmp(&lex->val.ident->namestr, "system")==0)
+            if (lexerIsToken(parse->lex, IdentToken)) {
+                if (strcmp(&parse->lex->val.ident->namestr, "system")==0)
                     extflag |= FlagSystem;
-                lexNextToken();
+                lexerNextToken(parse->lex);
             }
-            if (lexIsToken(ColonToken) || lexIsToken(LCurlyToken)) {
-                parseBlockStart();
-                while (!parseBlockEnd()) {
-                    lexStmtStart();
-                    if (lexIsToken(FnToken) || lexIsToken(PermToken))
+            if (lexerIsToken(parse->lex, ColonToken) || lexerIsToken(parse->lex, LCurlyToken)) {
+                parseBlockStart(parse);
+                while (!parseBlockEnd(parse)) {
+                    lexerStmtStart(parse->lex);
+                    if (lexerIsToken(parse->lex, FnToken) || lexerIsToken(parse->lex, PermToken))
                         parseFnOrVar(parse, extflag);
                     else {
-                        errorMsgLex(ErrorNoSemi, "Extern expects only functions and variables");
-                        parseSkipToNextStmt();
+                        errorMsgLexer(parse->lex, ErrorNoSemi, "Extern expects only functions and variables");
+                        parseSkipToNextStmt(parse);
                     }
                 }
             }
@@ -450,9 +513,9 @@ void parseGlobalStmts(ParseState *parse, ModuleNode *mod) {
         }
 
         default:
-            errorMsgLex(ErrorBadGloStmt, "Invalid global area statement");
-            lexNextToken();
-            parseSkipToNextStmt();
+            errorMsgLexer(parse->lex, ErrorBadGloStmt, "Invalid global area statement");
+            lexerNextToken(parse->lex);
+            parseSkipToNextStmt(parse);
             break;
         }
     }
@@ -475,32 +538,31 @@ ProgramNode *parsePgm(ConeOptions *opt) {
     nametblInit();
     typetblInit();
     lexInit(opt);
-    stdlibInit(opt->ptrsize);
-
-    ProgramNode *pgm = newProgramNode();
+    stdlibInit(opt->ptrsize, opt->rc32);
 
-    // Initialize parser state
+    // Initialize parser state, set up for parsing main source file
     ParseState parse;
-    parse.pgm = pgm;
+    parse.lex = newLexerFile(NULL, opt->srcpath);
     parse.mod = NULL;
     parse.typenode = NULL;
     parse.gennamePrefix = "";
 
-    // Create module node and set up for parsing main source file
-    ModuleNode *pgmmod = pgmAddMod(pgm);
+    // Create program and module node for main source file
+    ProgramNode *pgm = parsePos(&parse, newProgramNode());
+    parse.pgm = pgm;
+    ModuleNode *pgmmod = parsePos(&parse, pgmAddMod(pgm));
     parse.pgmmod = pgmmod;
-    lexInjectFile(opt->srcpath);
-    modHook(NULL, pgmmod);
 
     // Inject and parse core libary module, auto-imported into main source
     ModuleNode *corelib = parseImportModule(&parse, "", corelibName);
-    ImportNode *importnode = newImportNode();
+    parseQueuedModules(&parse);
+    ImportNode *importnode = parsePos(&parse, newImportNode());
     importnode->foldall = 1;
     importnode->module = corelib;
     modAddNode(pgmmod, NULL, (INode*)importnode);
 
-    // Now actually parse main source file
+    // Now actually parse main source file, then all modules it imports
     parseModuleBlk(&parse, pgmmod);
-    modHook(pgmmod, NULL);
+    parseQueuedModules(&parse);
     return pgm;
 }
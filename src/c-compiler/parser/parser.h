@@ -12,6 +12,7 @@
 typedef struct ConeOptions ConeOptions;
 
 typedef struct ParseState {
+    Lexer *lex;             // Lexer for the source being parsed
     ProgramNode *pgm;       // Program node
     ModuleNode *pgmmod;     // Root module for program
     ModuleNode *mod;        // Current module
@@ -31,25 +32,27 @@ enum ParseFlags {
 
 // parser.c
 ProgramNode *parsePgm(ConeOptions *opt);
+// Give a newly created node the source position of the parser's current token
+void *parsePos(ParseState *parse, void *node);
 ModuleNode *parseModuleBlk(ParseState *parse, ModuleNode *mod);
 INode *parseFn(ParseState *parse, uint16_t mayflags);
 // Skip to next statement for error recovery
-void parseSkipToNextStmt();
+void parseSkipToNextStmt(ParseState *parse);
 // Is this end-of-statement? if ';', '}', or end-of-file
-int parseIsEndOfStatement();
+int parseIsEndOfStatement(ParseState *parse);
 // We expect optional semicolon since statement has run its course
-void parseEndOfStatement();
+void parseEndOfStatement(ParseState *parse);
 // Return true on '{' or ':'
-int parseHasBlock();
+int parseHasBlock(ParseState *parse);
 // Expect a block to start, consume its token and set lexer mode
-void parseBlockStart();
+void parseBlockStart(ParseState *parse);
 // Are we at end of block yet? If so, consume token and reset lexer mode
-int parseBlockEnd();
+int parseBlockEnd(ParseState *parse);
 // Parse a list of generic variables and add to the genericnode
 Nodes *parseGenericParms(ParseState *parse);
 
 // Expect closing token (e.g., right parenthesis). If not found, search for it or '}' or ';'
-void parseCloseTok(uint16_t closetok);
+void parseCloseTok(ParseState *parse, uint16_t closetok);
 
 // parseflow.c
 INode *parseIf(ParseState *parse);
@@ -70,7 +73,7 @@ INode *parseTerm(ParseState *parse);
 INode *parsePrefix(ParseState *parse, int noSuffix);
 
 // parsetype.c
-INode *parsePerm();
+INode *parsePerm(ParseState *parse);
 VarDclNode *parseVarDcl(ParseState *parse, PermNode *defperm, uint16_t flags);
 ConstDclNode *parseConstDcl(ParseState *parse);
 INode *parseFnSig(ParseState *parse);
@@ -18,10 +18,10 @@
 #include <assert.h>
 
 // Parse a permission, return reference to defperm if not found
-INode *parsePerm() {
-    if (lexIsToken(PermToken)) {
-        INode *perm = newPermUseNode((PermNode*)lex->val.ident->node);
-        lexNextToken();
+INode *parsePerm(ParseState *parse) {
+    if (lexerIsToken(parse->lex, PermToken)) {
+        INode *perm = parsePos(parse, newPermUseNode((PermNode*)parse->lex->val.ident->node));
+        lexerNextToken(parse->lex);
         return perm;
     }
     return unknownType;
@@ -33,7 +33,7 @@ VarDclNode *parseVarDcl(ParseState *parse, PermNode *defperm, uint16_t flags) {
     INode *perm;
 
     // Grab the permission type
-    perm = parsePerm();
+    perm = parsePerm(parse);
     if (perm->tag == UnknownTag)
         perm = (INode*)defperm;
     INode *permdcl = iTypeGetTypeDcl(perm);
@@ -42,33 +42,33 @@ VarDclNode *parseVarDcl(ParseState *parse, PermNode *defperm, uint16_t flags) {
         errorMsgNode(perm, ErrorInvType, "Permission not valid for variable/field declaration");
 
     // Obtain variable's name
-    if (!lexIsToken(IdentToken)) {
-        errorMsgLex(ErrorNoIdent, "Expected variable name for declaration");
-        return newVarDclFull(anonName, VarDclTag, unknownType, perm, NULL);
+    if (!lexerIsToken(parse->lex, IdentToken)) {
+        errorMsgLexer(parse->lex, ErrorNoIdent, "Expected variable name for declaration");
+        return parsePos(parse, newVarDclFull(anonName, VarDclTag, unknownType, perm, NULL));
     }
-    varnode = newVarDclNode(lex->val.ident, VarDclTag, perm);
-    lexNextToken();
+    varnode = parsePos(parse, newVarDclNode(parse->lex->val.ident, VarDclTag, perm));
+    lexerNextToken(parse->lex);
 
     // Get value type, if provided
     varnode->vtype = parseVtype(parse);
 
     // Get initialization value after '=', if provided
-    if (lexIsToken(AssgnToken)) {
+    if (lexerIsToken(parse->lex, AssgnToken)) {
         if (!(flags&ParseMayImpl))
-            errorMsgLex(ErrorBadImpl, "A default/initial value may not be specified here.");
-        lexNextToken();
-        if (lexIsToken(UndefToken)) {
+            errorMsgLexer(parse->lex, ErrorBadImpl, "A default/initial value may not be specified here.");
+        lexerNextToken(parse->lex);
+        if (lexerIsToken(parse->lex, UndefToken)) {
             // 'undef' is used to signal that programmer believes variable
             // can be considered safely "initialized", even though it is UB.
             varnode->flowtempflags |= VarInitialized;
-            lexNextToken();
+            lexerNextToken(parse->lex);
         }
         else
             varnode->value = parseAnyExpr(parse);
     }
     else {
         if (!(flags&ParseMaySig))
-            errorMsgLex(ErrorNoInit, "Must specify default/initial value.");
+            errorMsgLexer(parse->lex, ErrorNoInit, "Must specify default/initial value.");
     }
 
     return varnode;
@@ -77,26 +77,26 @@ VarDclNode *parseVarDcl(ParseState *parse, PermNode *defperm, uint16_t flags) {
 // Parse a named constant declaration
 ConstDclNode *parseConstDcl(ParseState *parse) {
     ConstDclNode *constnode;
-    lexNextToken();
+    lexerNextToken(parse->lex);
 
     // Obtain name
-    if (!lexIsToken(IdentToken)) {
-        errorMsgLex(ErrorNoIdent, "Expected name for const declaration");
-        return newConstDclNode(anonName);
+    if (!lexerIsToken(parse->lex, IdentToken)) {
+        errorMsgLexer(parse->lex, ErrorNoIdent, "Expected name for const declaration");
+        return parsePos(parse, newConstDclNode(anonName));
     }
-    constnode = newConstDclNode(lex->val.ident);
-    lexNextToken();
+    constnode = parsePos(parse, newConstDclNode(parse->lex->val.ident));
+    lexerNextToken(parse->lex);
 
     // Get value type, if provided
     constnode->vtype = parseVtype(parse);
 
     // Get initialization value after '=', if provided
-    if (lexIsToken(AssgnToken)) {
-        lexNextToken();
+    if (lexerIsToken(parse->lex, AssgnToken)) {
+        lexerNextToken(parse->lex);
         constnode->value = parseAnyExpr(parse);
     }
     else {
-        errorMsgLex(ErrorNoInit, "Must specify const value.");
+        errorMsgLexer(parse->lex, ErrorNoInit, "Must specify const value.");
     }
 
     return constnode;
@@ -104,19 +104,19 @@ ConstDclNode *parseConstDcl(ParseState *parse) {
 
 INode *parseTypeName(ParseState *parse) {
     INode *node = parseNameUse(parse);
-    if (lexIsToken(LBracketToken)) {
-        FnCallNode *fncall = newFnCallNode(node, 8);
+    if (lexerIsToken(parse->lex, LBracketToken)) {
+        FnCallNode *fncall = parsePos(parse, newFnCallNode(node, 8));
         fncall->flags |= FlagIndex;
-        lexNextToken();
-        lexIncrParens();
-        if (!lexIsToken(RBracketToken)) {
+        lexerNextToken(parse->lex);
+        lexerIncrParens(parse->lex);
+        if (!lexerIsToken(parse->lex, RBracketToken)) {
             nodesAdd(&fncall->args, parseVtype(parse));
-            while (lexIsToken(CommaToken)) {
-                lexNextToken();
+            while (lexerIsToken(parse->lex, CommaToken)) {
+                lexerNextToken(parse->lex);
                 nodesAdd(&fncall->args, parseVtype(parse));
             }
         }
-        parseCloseTok(RBracketToken);
+        parseCloseTok(parse, RBracketToken);
         node = (INode *)fncall;
     }
     return node;
@@ -124,8 +124,8 @@ INode *parseTypeName(ParseState *parse) {
 
 // Parse an enum type
 INode* parseEnum(ParseState *parse) {
-    EnumNode *node = newEnumNode();
-    lexNextToken();
+    EnumNode *node = parsePos(parse, newEnumNode());
+    lexerNextToken(parse->lex);
     return (INode*)node;
 }
 
@@ -136,28 +136,28 @@ FieldDclNode *parseFieldDcl(ParseState *parse, PermNode *defperm) {
     INode *perm;
 
     // Grab the permission type
-    perm = parsePerm();
+    perm = parsePerm(parse);
     INode *permdcl = perm == unknownType? unknownType : iTypeGetTypeDcl(perm);
     if (permdcl != (INode*)mutPerm && permdcl == (INode*)immPerm)
         errorMsgNode(perm, ErrorInvType, "Permission not valid for field declaration");
 
     // Obtain variable's name
-    if (!lexIsToken(IdentToken)) {
-        errorMsgLex(ErrorNoIdent, "Expected field name for declaration");
-        return newFieldDclNode(anonName, perm);
+    if (!lexerIsToken(parse->lex, IdentToken)) {
+        errorMsgLexer(parse->lex, ErrorNoIdent, "Expected field name for declaration");
+        return parsePos(parse, newFieldDclNode(anonName, perm));
     }
-    fldnode = newFieldDclNode(lex->val.ident, perm);
-    lexNextToken();
+    fldnode = parsePos(parse, newFieldDclNode(parse->lex->val.ident, perm));
+    lexerNextToken(parse->lex);
 
     // Get value type, if provided
-    if (lexIsToken(EnumToken))
+    if (lexerIsToken(parse->lex, EnumToken))
         fldnode->vtype = parseEnum(parse);
     else if ((vtype = parseVtype(parse)))
         fldnode->vtype = vtype;
 
     // Get initialization value after '=', if provided
-    if (lexIsToken(AssgnToken)) {
-        lexNextToken();
+    if (lexerIsToken(parse->lex, AssgnToken)) {
+        lexerNextToken(parse->lex);
         fldnode->value = parseAnyExpr(parse);
     }
 
@@ -173,34 +173,34 @@ INode *parseStruct(ParseState *parse, uint16_t strflags) {
 
     // Capture the kind of type, then get next token (name)
     uint16_t tag = StructTag;
-    lexNextToken();
+    lexerNextToken(parse->lex);
 
     // Handle attributes
     while (1) {
-        if (lex->toktype == MoveToken) {
+        if (parse->lex->toktype == MoveToken) {
             strflags |= MoveType;
-            lexNextToken();
+            lexerNextToken(parse->lex);
         }
-        else if (lex->toktype == OpaqueToken) {
+        else if (parse->lex->toktype == OpaqueToken) {
             strflags |= OpaqueType;
-            lexNextToken();
+            lexerNextToken(parse->lex);
         }
         else
             break;
     }
 
     // Process struct type name, if provided
-    if (lexIsToken(IdentToken)) {
-        strnode = newStructNode(lex->val.ident);
+    if (lexerIsToken(parse->lex, IdentToken)) {
+        strnode = parsePos(parse, newStructNode(parse->lex->val.ident));
         strnode->tag = tag;
         strnode->flags |= strflags;
         strnode->mod = parse->mod;
         nameConcatPrefix(&parse->gennamePrefix, &strnode->namesym->namestr);
         parse->typenode = (INsTypeNode *)strnode;
-        lexNextToken();
+        lexerNextToken(parse->lex);
     }
     else {
-        errorMsgLex(ErrorNoIdent, "Expected a name for the type");
+        errorMsgLexer(parse->lex, ErrorNoIdent, "Expected a name for the type");
         return NULL;
     }
 
@@ -209,24 +209,24 @@ INode *parseStruct(ParseState *parse, uint16_t strflags) {
         methflags |= ParseMaySig;
 
     // Handle if generic parameters are found
-    if (lexIsToken(LBracketToken)) {
+    if (lexerIsToken(parse->lex, LBracketToken)) {
         strnode->genericinfo = newGenericInfo();
         strnode->genericinfo->parms = parseGenericParms(parse);
     }
 
     // Obtain base trait, if specified
-    if (lexIsToken(ExtendsToken)) {
-        lexNextToken();
+    if (lexerIsToken(parse->lex, ExtendsToken)) {
+        lexerNextToken(parse->lex);
         strnode->basetrait = parseTypeName(parse);  // Type could be a qualified name or generic
     }
 
     // If block has been provided, process field or method definitions
     int hasEnumFld = 0;
-    if (parseHasBlock()) {
-        parseBlockStart();
-        while (!parseBlockEnd()) {
-            lexStmtStart();
-            if (lexIsToken(FnToken)) {
+    if (parseHasBlock(parse)) {
+        parseBlockStart(parse);
+        while (!parseBlockEnd(parse)) {
+            lexerStmtStart(parse->lex);
+            if (lexerIsToken(parse->lex, FnToken)) {
                 FnDclNode *fn = (FnDclNode*)parseFn(parse, methflags);
                 if (fn && isNamedNode(fn)) {
                     Nodes *parms = ((FnSigNode *)fn->vtype)->parms;
@@ -236,27 +236,27 @@ INode *parseStruct(ParseState *parse, uint16_t strflags) {
                     iNsTypeAddFn((INsTypeNode*)strnode, fn);
                 }
             }
-            else if (lexIsToken(MixinToken)) {
+            else if (lexerIsToken(parse->lex, MixinToken)) {
                 // Handle a trait mixin, capturing it in a field-like node
-                FieldDclNode *field = newFieldDclNode(anonName, (INode*)immPerm);
+                FieldDclNode *field = parsePos(parse, newFieldDclNode(anonName, (INode*)immPerm));
                 field->flags |= IsMixin | FlagMethFld;
-                lexNextToken();
+                lexerNextToken(parse->lex);
                 INode *vtype;
                 if ((vtype = parseVtype(parse)))
                     field->vtype = vtype;
                 structAddField(strnode, field);
-                parseEndOfStatement();
+                parseEndOfStatement(parse);
             }
-            else if (lexIsToken(PermToken) || lexIsToken(IdentToken)) {
+            else if (lexerIsToken(parse->lex, PermToken) || lexerIsToken(parse->lex, IdentToken)) {
                 FieldDclNode *field = parseFieldDcl(parse, mutPerm);
                 field->index = fieldnbr++;
                 field->flags |= FlagMethFld;
                 if (field->vtype->tag == EnumTag)
                     hasEnumFld = 1;
                 structAddField(strnode, field);
-                parseEndOfStatement();
+                parseEndOfStatement(parse);
             }
-            else if (lexIsToken(StructToken)) {
+            else if (lexerIsToken(parse->lex, StructToken)) {
                 // If we see structs in trait/union, treat them as tagged extensions/derived structs
                 if (strnode->flags & TraitType) {
                     strnode->flags |= HasTagField;
@@ -266,26 +266,26 @@ INode *parseStruct(ParseState *parse, uint16_t strflags) {
 
                     // Build node that indicates this struct extends from trait
                     if (substruct->basetrait)
-                        errorMsgLex(ErrorNoIdent, "trait's struct must not specify extends");
-                    INode *traitref = (INode*)newNameUseNode(strnode->namesym);
+                        errorMsgLexer(parse->lex, ErrorNoIdent, "trait's struct must not specify extends");
+                    INode *traitref = (INode*)parsePos(parse, newNameUseNode(strnode->namesym));
 
                     // Inherit generic parms
                     if (substruct->genericinfo)
-                        errorMsgLex(ErrorNoIdent, "trait's struct must not specify generic parms");
+                        errorMsgLexer(parse->lex, ErrorNoIdent, "trait's struct must not specify generic parms");
                     if (strnode->genericinfo) {
                         substruct->genericinfo = newGenericInfo();
                         substruct->genericinfo->parms = newNodes(strnode->genericinfo->parms->used);
                         INode **nodesp;
                         uint32_t cnt;
                         for (nodesFor(strnode->genericinfo->parms, cnt, nodesp)) {
-                            GenVarDclNode *parm = newGVarDclNode(((GenVarDclNode*)*nodesp)->namesym);
+                            GenVarDclNode *parm = parsePos(parse, newGVarDclNode(((GenVarDclNode*)*nodesp)->namesym));
                             nodesAdd(&substruct->genericinfo->parms, (INode*)parm);
                         }
                         // traitref needs to be a generic-qualified base trait name
-                        FnCallNode *gentraitref = newFnCallNode(traitref, strnode->genericinfo->parms->used);
+                        FnCallNode *gentraitref = parsePos(parse, newFnCallNode(traitref, strnode->genericinfo->parms->used));
                         gentraitref->flags |= FlagIndex;
                         for (nodesFor(strnode->genericinfo->parms, cnt, nodesp)) {
-                            nodesAdd(&gentraitref->args, (INode*)newNameUseNode(((GenVarDclNode *)*nodesp)->namesym));
+                            nodesAdd(&gentraitref->args, (INode*)parsePos(parse, newNameUseNode(((GenVarDclNode *)*nodesp)->namesym)));
                         }
                         traitref = (INode *)gentraitref;
                     }
@@ -299,23 +299,23 @@ INode *parseStruct(ParseState *parse, uint16_t strflags) {
                     modAddNode(parse->mod, inodeGetName((INode*)substruct), (INode*)substruct);
                 }
                 else {
-                    errorMsgLex(ErrorNoIdent, "structs in structs not yet supported");
+                    errorMsgLexer(parse->lex, ErrorNoIdent, "structs in structs not yet supported");
                     parseStruct(parse, 0);
                 }
             }
             else {
-                errorMsgLex(ErrorNoSemi, "Unknown struct statement.");
-                parseSkipToNextStmt();
+                errorMsgLexer(parse->lex, ErrorNoSemi, "Unknown struct statement.");
+                parseSkipToNextStmt(parse);
             }
         }
     }
     else
-        parseEndOfStatement();
+        parseEndOfStatement(parse);
 
     // If a trait that needs a tag field doesn't have one, insert default enum field as first field
     if ((strnode->flags & (TraitType | HasTagField)) && !hasEnumFld) {
-        FieldDclNode *fldnode = newFieldDclNode(anonName, (INode*)immPerm);
-        fldnode->vtype = (INode*)newEnumNode();
+        FieldDclNode *fldnode = parsePos(parse, newFieldDclNode(anonName, (INode*)immPerm));
+        fldnode->vtype = (INode*)parsePos(parse, newEnumNode());
         nodelistInsert(&strnode->fields, 0, (INode*)fldnode);
     }
 
@@ -331,24 +331,24 @@ INode *parseFnSig(ParseState *parse) {
     uint16_t parseflags = ParseMaySig | ParseMayImpl;
 
     // Set up memory block for the function's type signature
-    fnsig = newFnSigNode();
+    fnsig = parsePos(parse, newFnSigNode());
 
     // Process parameter declarations
-    if (lexIsToken(LParenToken)) {
-        lexNextToken();
-        while (lexIsToken(PermToken) || lexIsToken(IdentToken)) {
+    if (lexerIsToken(parse->lex, LParenToken)) {
+        lexerNextToken(parse->lex);
+        while (lexerIsToken(parse->lex, PermToken) || lexerIsToken(parse->lex, IdentToken)) {
             VarDclNode *parm = parseVarDcl(parse, immPerm, parseflags);
             parm->flowtempflags |= VarInitialized;   // parameter vars always start with a valid value
             // Do special inference if function is a type's method
             if (parse->typenode) {
                 // Infer value type of a parameter (or its reference) if unspecified
                 if (parm->vtype == unknownType) {
-                    parm->vtype = (INode*)newNameUseNode(selfTypeName);
+                    parm->vtype = (INode*)parsePos(parse, newNameUseNode(selfTypeName));
                 }
                 else if (parm->vtype->tag == RefTag) {
                     RefNode *refnode = (RefNode *)parm->vtype;
                     if (refnode->vtexp == unknownType) {
-                        refnode->vtexp = (INode*)newNameUseNode(selfTypeName);
+                        refnode->vtexp = (INode*)parsePos(parse, newNameUseNode(selfTypeName));
                     }
                 }
             }
@@ -358,23 +358,23 @@ INode *parseFnSig(ParseState *parse) {
             if (parm->value)
                 parseflags = ParseMayImpl; // force remaining parms to specify default
             nodesAdd(&fnsig->parms, (INode*)parm);
-            if (!lexIsToken(CommaToken))
+            if (!lexerIsToken(parse->lex, CommaToken))
                 break;
-            lexNextToken();
+            lexerNextToken(parse->lex);
         }
-        parseCloseTok(RParenToken);
+        parseCloseTok(parse, RParenToken);
     }
     else
-        errorMsgLex(ErrorNoLParen, "Expected left parenthesis for parameter declarations");
+        errorMsgLexer(parse->lex, ErrorNoLParen, "Expected left parenthesis for parameter declarations");
 
     // Parse return type info - turn into void if none specified
     if ((fnsig->rettype = parseVtype(parse)) != unknownType) {
         // Handle multiple return types
-        if (lexIsToken(CommaToken)) {
-            TupleNode *rettype = newTupleNode(4);
+        if (lexerIsToken(parse->lex, CommaToken)) {
+            TupleNode *rettype = parsePos(parse, newTupleNode(4));
             nodesAdd(&rettype->elems, fnsig->rettype);
-            while (lexIsToken(CommaToken)) {
-                lexNextToken();
+            while (lexerIsToken(parse->lex, CommaToken)) {
+                lexerNextToken(parse->lex);
                 nodesAdd(&rettype->elems, parseVtype(parse));
             }
             fnsig->rettype = (INode*)rettype;
@@ -390,23 +390,23 @@ INode *parseFnSig(ParseState *parse) {
 
 // Parse a typedef statement
 TypedefNode *parseTypedef(ParseState *parse) {
-    lexNextToken();
+    lexerNextToken(parse->lex);
     // Process struct type name, if provided
-    if (!lexIsToken(IdentToken)) {
-        errorMsgLex(ErrorNoIdent, "Expected a name for the type");
+    if (!lexerIsToken(parse->lex, IdentToken)) {
+        errorMsgLexer(parse->lex, ErrorNoIdent, "Expected a name for the type");
         return NULL;
     }
-    TypedefNode *newnode = newTypedefNode(lex->val.ident);
-    lexNextToken();
+    TypedefNode *newnode = parsePos(parse, newTypedefNode(parse->lex->val.ident));
+    lexerNextToken(parse->lex);
     newnode->typeval = parseVtype(parse);
-    parseEndOfStatement();
+    parseEndOfStatement(parse);
     return newnode;
 }
 
 // Parse a type expression. Return unknownType if none found.
 INode* parseVtype(ParseState *parse) {
     // This is a placeholder since parser converges type and value expression parsing
-    switch (lex->toktype) {
+    switch (parse->lex->toktype) {
     case QuesToken:
     case AmperToken:
     case ArrayRefToken:
@@ -12,19 +12,55 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <stdarg.h>
 
 int errors = 0;
 int warnings = 0;
 
+// Diagnostics options
+int errorJson = 0;      // Buffer diagnostics and write them out as JSON at exit
+int errorMax = 0;       // Stop compiling after this many errors (0 = no limit)
+
+// A diagnostic buffered for JSON output
+typedef struct ErrorDiag {
+    char *url;              // Source file (or NULL)
+    char *msg;              // Formatted message
+    struct ErrorDiag *notes; // Uncounted notes that follow this diagnostic
+    struct ErrorDiag *next; // Next note
+    uint32_t line;          // 1-based line (0 when no source position)
+    uint32_t col;           // 1-based column
+    uint32_t seq;           // Order reported, so sorting is stable
+    int code;
+} ErrorDiag;
+
+ErrorDiag **errorDiags = NULL;
+uint32_t errorDiagCnt = 0;
+uint32_t errorDiagSize = 0;
+
+void errorJsonWrite(char *fatal);
+
+// Configure how diagnostics are reported
+void errorSetup(int json, int maxerrors) {
+    errorJson = json;
+    errorMax = maxerrors;
+}
+
 // Send an error message to stderr
 void errorExit(int exitcode, const char *msg, ...) {
     // Do a formatted output, passing along all args
     va_list argptr;
     va_start(argptr, msg);
-    vfprintf(stderr, msg, argptr);
+    if (errorJson) {
+        char fatal[512];
+        vsnprintf(fatal, sizeof(fatal), msg, argptr);
+        errorJsonWrite(fatal);
+    }
+    else {
+        vfprintf(stderr, msg, argptr);
+        fputs("\n", stderr);
+    }
     va_end(argptr);
-    fputs("\n", stderr);
 
     // Exit with return code
 #ifdef _DEBUG
@@ -33,17 +69,90 @@ void errorExit(int exitcode, const char *msg, ...) {
     exit(exitcode);
 }
 
+// Count an error or warning
+void errorCount(int code) {
+    if (code < WarnCode)
+        errors++;
+    else if (code < Uncounted)
+        warnings++;
+}
+
+// Stop the compile once too many errors have been reported
+void errorCheckMax() {
+    if (errorMax > 0 && errors >= errorMax)
+        errorExit(ExitError, "Unsuccessful compile: stopped after %d errors", errors);
+}
+
+int errorDiagIsDup(ErrorDiag *diag, ErrorDiag *prev);
+int errorDiagDropNotes = 0;  // The last diagnostic was a repeat, so drop its notes too
+
+// Buffer a diagnostic for JSON output. A repeat of an earlier diagnostic
+// (e.g., reported again by another generic instantiation) is dropped: return 0.
+int errorDiagAdd(Lexer *lexer, uint32_t srcoff, int code, const char *msg, va_list args) {
+    ErrorDiag *diag = memAllocBlk(sizeof(ErrorDiag));
+    va_list argscopy;
+    va_copy(argscopy, args);
+    int len = vsnprintf(NULL, 0, msg, argscopy);
+    va_end(argscopy);
+    diag->msg = memAllocBlk(len + 1);
+    vsnprintf(diag->msg, len + 1, msg, args);
+    diag->code = code;
+    diag->notes = diag->next = NULL;
+    diag->url = NULL;
+    diag->line = diag->col = 0;
+    if (lexer) {
+        char *linep;
+        diag->url = lexer->url;
+        diag->line = lexerLineOf(lexer, srcoff, &linep);
+        diag->col = (uint32_t)(lexer->source + srcoff - linep) + 1;
+    }
+
+    // A note belongs to the diagnostic it follows
+    if (code >= Uncounted && errorDiagCnt > 0) {
+        if (errorDiagDropNotes)
+            return 0;
+        ErrorDiag **notep = &errorDiags[errorDiagCnt - 1]->notes;
+        while (*notep)
+            notep = &(*notep)->next;
+        *notep = diag;
+        return 1;
+    }
+
+    errorDiagDropNotes = 0;
+    for (uint32_t i = 0; i < errorDiagCnt; ++i) {
+        if (errorDiagIsDup(diag, errorDiags[i])) {
+            errorDiagDropNotes = 1;
+            return 0;
+        }
+    }
+
+    if (errorDiagCnt >= errorDiagSize) {
+        uint32_t newsize = errorDiagSize == 0 ? 64 : errorDiagSize << 1;
+        ErrorDiag **diags = memAllocBlk(newsize * sizeof(ErrorDiag*));
+        if (errorDiagCnt)
+            memcpy(diags, errorDiags, errorDiagCnt * sizeof(ErrorDiag*));
+        errorDiags = diags;
+        errorDiagSize = newsize;
+    }
+    diag->seq = errorDiagCnt;
+    errorDiags[errorDiagCnt++] = diag;
+    return 1;
+}
+
 // Send an error message to stderr
 void errorOut(int code, const char *msg, va_list args) {
+    if (errorJson) {
+        if (errorDiagAdd(NULL, 0, code, msg, args))
+            errorCount(code);
+        return;
+    }
+    errorCount(code);
+
     // Prefix for error message
-    if (code < WarnCode) {
-        errors++;
+    if (code < WarnCode)
         fprintf(stderr, "Error %d: ", code);
-    }
-    else if (code < Uncounted) {
-        warnings++;
+    else if (code < Uncounted)
         fprintf(stderr, "Warning %d: ", code);
-    }
 
     // Do a formatted output of message, passing along all args
     vfprintf(stderr, msg, args);
@@ -51,12 +160,23 @@ void errorOut(int code, const char *msg, va_list args) {
 }
 
 // Send an error message plus code context to stderr
-void errorOutCode(char *tokp, uint32_t linenbr, char *linep, char *url, int code, const char *msg, va_list args) {
-    char *srcp;
+void errorOutCode(Lexer *lexer, uint32_t srcoff, int code, const char *msg, va_list args) {
+    char *srcp, *linep;
     int pos, spaces;
 
+    if (errorJson) {
+        if (errorDiagAdd(lexer, srcoff, code, msg, args))
+            errorCount(code);
+        return;
+    }
+
     // Send out the error message and count
     errorOut(code, msg, args);
+    if (lexer == NULL)
+        return;     // Node has no source position
+
+    // Find line info for source position
+    uint32_t linenbr = lexerLineOf(lexer, srcoff, &linep);
 
     // Reflect the source code line
     fputs(" --> ", stderr);
@@ -67,30 +187,32 @@ void errorOutCode(char *tokp, uint32_t linenbr, char *linep, char *url, int code
 
     // Depict where error message applies along with source file/pos info
     fprintf(stderr, "     ");
-    pos = (spaces = tokp - linep) + 1;
+    pos = (spaces = lexer->source + srcoff - linep) + 1;
     srcp = linep;
     while (spaces--) {
         fputc(*srcp++ == '\t'? '\t' : ' ', stderr);
     }
-    fprintf(stderr, "^--- %s:%d:%d\n", url, linenbr, pos);
+    fprintf(stderr, "^--- %s:%d:%d\n", lexer->url, linenbr, pos);
 }
 
 // Send an error message to stderr
 void errorMsgNode(INode *node, int code, const char *msg, ...) {
     va_list argptr;
     va_start(argptr, msg);
-    errorOutCode(node->srcp, node->linenbr, node->linep, node->lexer->url, code, msg, argptr);
+    errorOutCode(node->lexer, node->srcoff, code, msg, argptr);
     va_end(argptr);
     if (node->instnode)
         errorMsgNode(node->instnode, Uncounted, "... as instantiated by this part of the source code");
+    errorCheckMax();
 }
 
-// Send an error message to stderr
-void errorMsgLex(int code, const char *msg, ...) {
+// Send an error message to stderr, positioned at a specific lexer's current token
+void errorMsgLexer(Lexer *lexer, int code, const char *msg, ...) {
     va_list argptr;
     va_start(argptr, msg);
-    errorOutCode(lex->tokp, lex->linenbr, lex->linep, lex->url, code, msg, argptr);
+    errorOutCode(lexer, (uint32_t)(lexer->tokp - lexer->source), code, msg, argptr);
     va_end(argptr);
+    errorCheckMax();
 }
 
 // Send an error message to stderr
@@ -99,10 +221,131 @@ void errorMsg(int code, const char *msg, ...) {
     va_start(argptr, msg);
     errorOut(code, msg, argptr);
     va_end(argptr);
+    errorCheckMax();
+}
+
+// The JSON document is built in memory, then written to stderr all at once
+char *errorJsonBuf = NULL;
+size_t errorJsonLen = 0;
+size_t errorJsonSize = 0;
+
+// Append bytes to the JSON document
+void errorJsonPut(const char *str, size_t len) {
+    if (errorJsonLen + len > errorJsonSize) {
+        size_t newsize = errorJsonSize == 0 ? 4096 : errorJsonSize << 1;
+        while (newsize < errorJsonLen + len)
+            newsize <<= 1;
+        char *buf = memAllocBlk(newsize);
+        if (errorJsonLen)
+            memcpy(buf, errorJsonBuf, errorJsonLen);
+        errorJsonBuf = buf;
+        errorJsonSize = newsize;
+    }
+    memcpy(errorJsonBuf + errorJsonLen, str, len);
+    errorJsonLen += len;
+}
+
+// Append formatted text to the JSON document
+void errorJsonPrint(const char *fmt, ...) {
+    char text[256];
+    va_list argptr;
+    va_start(argptr, fmt);
+    int len = vsnprintf(text, sizeof(text), fmt, argptr);
+    va_end(argptr);
+    errorJsonPut(text, len < (int)sizeof(text) ? len : sizeof(text) - 1);
+}
+
+// Output a string as a JSON string value
+void errorJsonStr(char *str) {
+    errorJsonPut("\"", 1);
+    for (; *str; str++) {
+        // Copy over the run of characters that need no escaping
+        char *run = str;
+        while (*str && (unsigned char)*str >= ' ' && *str != '"' && *str != '\\')
+            ++str;
+        errorJsonPut(run, str - run);
+        if (*str == '\0')
+            break;
+        if (*str == '"' || *str == '\\')
+            errorJsonPrint("\\%c", *str);
+        else
+            errorJsonPrint("\\u%04x", (unsigned char)*str);
+    }
+    errorJsonPut("\"", 1);
+}
+
+// Output one diagnostic as a JSON object
+void errorJsonDiag(ErrorDiag *diag) {
+    errorJsonPrint("{\"severity\":\"%s\",\"code\":%d,\"message\":",
+        diag->code < WarnCode ? "error" : diag->code < Uncounted ? "warning" : "note", diag->code);
+    errorJsonStr(diag->msg);
+    if (diag->url) {
+        errorJsonPrint(",\"file\":");
+        errorJsonStr(diag->url);
+        errorJsonPrint(",\"line\":%u,\"column\":%u", diag->line, diag->col);
+    }
+    if (diag->notes) {
+        errorJsonPrint(",\"notes\":[");
+        for (ErrorDiag *note = diag->notes; note; note = note->next) {
+            errorJsonDiag(note);
+            if (note->next)
+                errorJsonPrint(",");
+        }
+        errorJsonPrint("]");
+    }
+    errorJsonPrint("}");
+}
+
+// Order diagnostics by source file and position, then by when they were reported
+int errorDiagCmp(const void *a, const void *b) {
+    ErrorDiag *diag1 = *(ErrorDiag **)a;
+    ErrorDiag *diag2 = *(ErrorDiag **)b;
+    int cmp = strcmp(diag1->url ? diag1->url : "", diag2->url ? diag2->url : "");
+    if (cmp)
+        return cmp;
+    if (diag1->line != diag2->line)
+        return diag1->line < diag2->line ? -1 : 1;
+    if (diag1->col != diag2->col)
+        return diag1->col < diag2->col ? -1 : 1;
+    return diag1->seq < diag2->seq ? -1 : diag1->seq > diag2->seq;
+}
+
+// Is this diagnostic a repeat of an earlier one?
+int errorDiagIsDup(ErrorDiag *diag, ErrorDiag *prev) {
+    return prev && diag->code == prev->code && diag->line == prev->line && diag->col == prev->col
+        && strcmp(diag->url ? diag->url : "", prev->url ? prev->url : "") == 0
+        && strcmp(diag->msg, prev->msg) == 0;
+}
+
+// Write out all buffered diagnostics as a single JSON document (plus any fatal message).
+// Repeats were dropped as they were reported, so the counts match errors and warnings.
+void errorJsonWrite(char *fatal) {
+    qsort(errorDiags, errorDiagCnt, sizeof(ErrorDiag*), errorDiagCmp);
+    errorJsonLen = 0;
+    errorJsonPrint("{\"diagnostics\":[");
+    for (uint32_t i = 0; i < errorDiagCnt; ++i) {
+        errorJsonPrint(i > 0 ? ",\n" : "\n");
+        errorJsonDiag(errorDiags[i]);
+    }
+    errorJsonPrint("],\n\"errors\":%d,\"warnings\":%d", errors, warnings);
+    if (fatal) {
+        errorJsonPrint(",\"fatal\":");
+        errorJsonStr(fatal);
+    }
+    errorJsonPrint("}\n");
+    fwrite(errorJsonBuf, 1, errorJsonLen, stderr);
+    fflush(stderr);
+    errorDiagCnt = 0;
 }
 
 // Generate final message for a compile
 void errorSummary() {
+    if (errorJson) {
+        errorJsonWrite(NULL);
+        if (errors > 0)
+            exit(ExitError);
+        return;
+    }
     if (errors > 0)
         errorExit(ExitError, "Unsuccessful compile: %d errors, %d warnings", errors, warnings);
     fprintf(stderr, "Compile finished in %.6g sec (%lu kb). %d warnings detected\n", timerSummary(), memUsed()/1024, warnings);
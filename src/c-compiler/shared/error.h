@@ -9,6 +9,7 @@
 #define error_h
 
 typedef struct INode INode;    // ../ast/ast.h
+typedef struct Lexer Lexer;    // ../parser/lexer.h
 
 // Exit error codes
 enum ErrorCode {
@@ -87,10 +88,15 @@ enum ErrorCode {
 
 extern int errors;
 
+// Configure how diagnostics are reported:
+// - json buffers diagnostics, writing them out sorted and de-duplicated as JSON at exit
+// - maxerrors stops the compile after that many errors (0 = no limit)
+void errorSetup(int json, int maxerrors);
+
 // Send an error message to stderr
 void errorExit(int exitcode, const char *msg, ...);
 void errorMsgNode(INode *node, int code, const char *msg, ...);
-void errorMsgLex(int code, const char *msg, ...);
+void errorMsgLexer(Lexer *lexer, int code, const char *msg, ...);
 void errorMsg(int code, const char *msg, ...);
 void errorSummary();
 
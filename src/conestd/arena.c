@@ -0,0 +1,81 @@
+/** arena - Runtime support for the arena region
+ * @file
+ *
+ * Compiled code bump-allocates inline from arenaNext up to arenaEnd,
+ * calling arenaAlloc only when the current chunk is out of room.
+ * Nothing is freed individually: the host releases a thread's chunks back to a mark,
+ * or all at once (see arena.h). Cone code cannot, as every arena reference the
+ * thread still holds would be left dangling.
+ *
+ * This source file is part of the Cone Programming Language C compiler
+ * See Copyright Notice in conec.h
+*/
+
+#include "arena.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+
+#define ArenaChunkSize 65536
+#define ArenaAlign 16
+
+// Every chunk starts with a header that links it to the thread's previous chunk
+typedef struct ArenaChunk {
+    struct ArenaChunk *prev;
+} ArenaChunk;
+#define ArenaHdrSize ((sizeof(ArenaChunk) + ArenaAlign - 1) & ~(size_t)(ArenaAlign - 1))
+
+_Thread_local char *arenaNext = NULL;
+_Thread_local char *arenaEnd = NULL;
+static _Thread_local ArenaChunk *arenaChunks = NULL;
+
+// Allocate size bytes from a new chunk (called when the current chunk lacks room)
+char *arenaAlloc(size_t size) {
+    size = (size + ArenaAlign - 1) & ~(size_t)(ArenaAlign - 1);
+
+    // An oversized allocation gets a chunk of its own, leaving the current chunk in use
+    int dedicated = size > ArenaChunkSize / 4;
+    size_t chunksize = ArenaHdrSize + (dedicated ? size : ArenaChunkSize);
+    ArenaChunk *chunk = (ArenaChunk *)malloc(chunksize);
+    if (chunk == NULL)
+        abort();
+    chunk->prev = arenaChunks;
+    arenaChunks = chunk;
+
+    char *mem = (char *)chunk + ArenaHdrSize;
+    if (!dedicated) {
+        arenaNext = mem + size;
+        arenaEnd = (char *)chunk + chunksize;
+    }
+    return mem;
+}
+
+// Note where the current thread's arena stands, for a later arenaRelease
+ArenaMark arenaMark() {
+    ArenaMark mark;
+    mark.chunks = arenaChunks;
+    mark.next = arenaNext;
+    mark.end = arenaEnd;
+    return mark;
+}
+
+// Release everything the current thread allocated from the arena since mark was taken.
+// Chunks added since then are freed, and the bump pointer goes back to where it was
+// in the chunk that was current then (which is never one of the freed chunks).
+void arenaRelease(ArenaMark mark) {
+    ArenaChunk *chunk = arenaChunks;
+    while (chunk != (ArenaChunk *)mark.chunks) {
+        ArenaChunk *prev = chunk->prev;
+        free(chunk);
+        chunk = prev;
+    }
+    arenaChunks = chunk;
+    arenaNext = mark.next;
+    arenaEnd = mark.end;
+}
+
+// Release everything the current thread has allocated from the arena
+void arenaFree() {
+    ArenaMark start = {NULL, NULL, NULL};
+    arenaRelease(start);
+}
@@ -0,0 +1,50 @@
+/** arena - Host API for the arena region's memory
+ * @file
+ *
+ * Cone code allocates '+arena' references by bumping arenaNext towards arenaEnd,
+ * calling arenaAlloc for a new chunk when the current one is out of room.
+ * Each thread has its own chunks. Nothing is freed one reference at a time,
+ * and Cone code cannot release the arena: a release would leave every arena
+ * reference it still holds dangling. The host program releases it instead,
+ * once it knows no arena reference made since that point is still in use:
+ *
+ *   ArenaMark mark = arenaMark();
+ *   handleRequest(req);     // Cone code that allocates from the arena
+ *   arenaRelease(mark);     // Frees only what handleRequest allocated
+ *
+ * arenaFree() releases everything the thread allocated, e.g., when it ends.
+ *
+ * This source file is part of the Cone Programming Language C compiler
+ * See Copyright Notice in conec.h
+*/
+
+#ifndef arena_h
+#define arena_h
+
+#include <stddef.h>
+
+// Where the current thread's arena stood at some point, to release back to
+typedef struct ArenaMark {
+    void *chunks;    // Newest chunk at that point
+    char *next;      // Bump pointer at that point
+    char *end;       // End of the chunk it was bumping through
+} ArenaMark;
+
+// The current thread's bump pointer and the end of its current chunk (used by generated code)
+extern _Thread_local char *arenaNext;
+extern _Thread_local char *arenaEnd;
+
+// Allocate size bytes from a new chunk (called by generated code when the current chunk lacks room)
+char *arenaAlloc(size_t size);
+
+// Note where the current thread's arena stands, for a later arenaRelease
+ArenaMark arenaMark();
+
+// Release everything the current thread allocated from the arena since mark was taken.
+// Marks must be released newest first: releasing a mark also releases any taken after it.
+void arenaRelease(ArenaMark mark);
+
+// Release everything the current thread has allocated from the arena
+void arenaFree();
+
+#endif
@@ -0,0 +1,66 @@
+/** pool - Size-class pool allocator for so and rc allocations
+ * @file
+ *
+ * The compiler knows the size of every fixed-size so/rc allocation, so it calls
+ * the entry point for its 16-byte size class directly (e.g., poolAlloc32, poolFree32).
+ * Each class keeps a thread-local free list of blocks carved out of malloc'd slabs.
+ * Slabs are never returned to malloc: freed blocks are reused by later allocations.
+ * A block must be freed on the thread that allocated it, so arc allocations use malloc.
+ *
+ * This source file is part of the Cone Programming Language C compiler
+ * See Copyright Notice in conec.h
+*/
+
+#include <stddef.h>
+#include <stdlib.h>
+
+#define PoolGranule 16
+#define PoolClasses 16
+#define PoolSlabSize 65536
+
+typedef struct PoolBlock {
+    struct PoolBlock *next;
+} PoolBlock;
+
+static _Thread_local PoolBlock *poolFreeLists[PoolClasses];
+
+// Carve a new slab into blocks for a size class, returning one and listing the rest as free
+static char *poolRefill(int sizeclass) {
+    size_t blksize = (size_t)(sizeclass + 1) * PoolGranule;
+    char *slab = (char *)malloc(PoolSlabSize);
+    if (slab == NULL)
+        return NULL;
+    size_t nblks = PoolSlabSize / blksize;
+    PoolBlock *list = NULL;
+    for (size_t i = nblks - 1; i > 0; --i) {
+        PoolBlock *blk = (PoolBlock *)(slab + i * blksize);
+        blk->next = list;
+        list = blk;
+    }
+    poolFreeLists[sizeclass] = list;
+    return slab;
+}
+
+static inline char *poolAllocClass(int sizeclass) {
+    PoolBlock *blk = poolFreeLists[sizeclass];
+    if (blk == NULL)
+        return poolRefill(sizeclass);
+    poolFreeLists[sizeclass] = blk->next;
+    return (char *)blk;
+}
+
+static inline void poolFreeClass(int sizeclass, char *p) {
+    PoolBlock *blk = (PoolBlock *)p;
+    blk->next = poolFreeLists[sizeclass];
+    poolFreeLists[sizeclass] = blk;
+}
+
+// Size-specialized entry points called by generated code
+#define PoolEntry(size) \
+    char *poolAlloc##size() { return poolAllocClass(size / PoolGranule - 1); } \
+    void poolFree##size(char *p) { poolFreeClass(size / PoolGranule - 1, p); }
+
+PoolEntry(16)  PoolEntry(32)  PoolEntry(48)  PoolEntry(64)
+PoolEntry(80)  PoolEntry(96)  PoolEntry(112) PoolEntry(128)
+PoolEntry(144) PoolEntry(160) PoolEntry(176) PoolEntry(192)
+PoolEntry(208) PoolEntry(224) PoolEntry(240) PoolEntry(256)
@@ -0,0 +1,30 @@
+/** rccount - Runtime support for counting rc/arc counter updates
+ * @file
+ *
+ * Code compiled with --rc-count adds one to rcOpCount each time it updates an
+ * rc or arc reference counter, and runs rcOpCountStart before main so the total
+ * is printed to stderr at exit. Comparing a program's totals when compiled with
+ * and without --no-rc-elide shows how many updates the flow pass removed.
+ *
+ * This source file is part of the Cone Programming Language C compiler
+ * See Copyright Notice in conec.h
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+uint64_t rcOpCount = 0;
+
+static void rcOpCountPrint() {
+    fprintf(stderr, "rc counter updates: %llu\n", (unsigned long long)rcOpCount);
+}
+
+// Arrange for the count to be printed at exit (once, however many modules ask)
+void rcOpCountStart() {
+    static int started = 0;
+    if (!started) {
+        started = 1;
+        atexit(rcOpCountPrint);
+    }
+}
@@ -0,0 +1,42 @@
+/** Host program releasing the arena that Cone code allocates from
+ * @file
+ *
+ * Returns 0 on success.
+ *
+ * This source file is part of the Cone Programming Language C compiler
+ * See Copyright Notice in conec.h
+*/
+
+#include "arena.h"
+
+int arenaSum(int n);
+
+int main() {
+    // Many chunks' worth of allocations, released back to an empty arena
+    ArenaMark empty = arenaMark();
+    if (arenaSum(100000) != 704982704 || arenaNext == NULL)
+        return 1;
+    arenaRelease(empty);
+    if (arenaNext != NULL || arenaEnd != NULL)
+        return 2;
+
+    // Release back to a mark taken part way into a chunk, over and over.
+    // Each pass reuses the same memory, so the arena does not grow.
+    arenaSum(10);
+    ArenaMark mark = arenaMark();
+    for (int pass = 0; pass < 100; ++pass) {
+        if (arenaSum(10000) != 49995000)
+            return 3;
+        ArenaMark inner = arenaMark();
+        arenaSum(100000);
+        arenaRelease(inner);
+        if (arenaNext != inner.next || arenaEnd != inner.end)
+            return 4;
+        arenaRelease(mark);
+        if (arenaNext != mark.next || arenaEnd != mark.end)
+            return 5;
+    }
+
+    arenaFree();
+    return arenaNext == NULL ? 0 : 6;
+}